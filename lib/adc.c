@@ -27,6 +27,20 @@
             Batterie und OdometrieData Funktionen umbenannt in 
             Battery und OdometryData.\n    
             Alte Funktionsnamen ueber Defines beibehalten   
+  \version  V005 - 17.10.2026\n
+            ADC Sequencer: AdcScanStart(), AdcScanStop(), AdcScanList(),\n
+            AdcValue(), AdcRead(). Battery, LineData und OdometryData\n
+            liefern die Werte aus dem Sequencer ohne Warten auf den Wandler.
+  \version  V006 - 17.10.2026\n
+            Oversampling je Kanal: AdcOversample(), AdcValueExt()
+  \version  V007 - 17.10.2026\n
+            Fremdlichtkompensation: LineCompensation(), LineDataComp()
+  \version  V008 - 17.10.2026\n
+            Rueckruffunktion je Kanal: AdcHook()
+  \version  V009 - 17.10.2026\n
+            +++ AdcRead()\n
+            Kanaele ausserhalb der Kanalliste als Einzelmessung im laufenden\n
+            Sequencer (adconeshot), statt ihn anzuhalten und neu zu starten
 
 *****************************************************************************/
 /*****************************************************************************
@@ -41,6 +55,416 @@
 
 
 
+/****************************************************************************/
+/*!
+  \brief
+  Startet den ADC Sequencer.\n
+  Der AD-Wandler misst danach im Interrupt SIG_ADC reihum alle Kanaele aus\n
+  der Kanalliste adcscan und (bei laufender Odometrie) die Radsensoren.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \see
+  Init() startet den Sequencer bereits. Die Funktion wird nur benoetigt,\n
+  wenn der AD-Wandler vorher anderweitig benutzt wurde (z.B. Ultraschall)\n
+  oder nachdem der Sequencer mit AdcScanStop() angehalten wurde.
+
+  \par  Hinweis:
+  Alle Werte in adcvalue gelten bis zur ersten neuen Messung als ungueltig.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  AdcScanStop ();
+  // AD-Wandler fuer etwas anderes benutzen
+  AdcScanStart ();
+  \endcode
+*****************************************************************************/
+void AdcScanStart (
+  void)
+{
+  unsigned char i;
+
+  AdcScanStop ();
+
+  for (i = 0; i < ADC_CHANNELS; i++)
+  {
+    adcacc [i] = 0;
+    adccnt [i] = 0;
+  }
+  adcvalid   = 0;
+  adconeshot = ADC_ONESHOT_NONE;
+  adcscanon  = TRUE;
+  /*
+    Erste Wandlung auf dem linken Radsensor, der Rest laeuft im Interrupt.
+  */
+  ADMUX  = (1 << REFS0) | WHEEL_LEFT;
+  ADCSRA = (1 << ADEN) | (1 << ADIE) | (1 << ADIF) | (1 << ADSC) |
+           (1 << ADPS2) | (1 << ADPS1); // MCU-Takt/64
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Haelt den ADC Sequencer an.\n
+  Die Funktionen Battery(), LineData(), OdometryData() und PollSwitch()\n
+  messen danach wieder direkt und warten auf das Ende der Wandlung.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Beispiel:
+  (siehe unter AdcScanStart)
+*****************************************************************************/
+void AdcScanStop (
+  void)
+{
+  adcscanon = FALSE;                    // Interrupt startet nicht mehr neu
+  while (ADCSRA & (1 << ADSC))          // laufende Wandlung abwarten
+    ;
+  ADCSRA = (ADCSRA & ~(1 << ADIE)) | (1 << ADIF);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Setzt die Kanalliste des ADC Sequencers.\n
+  Die Radsensoren werden bei laufender Odometrie immer zusaetzlich\n
+  gemessen und muessen nicht angegeben werden.
+
+  \param[in]
+  list Liste der Kanaele: IR_LEFT, IR_RIGHT, BATTERIE, SWITCH
+  \param[in]
+  n Anzahl der Kanaele (max. ADC_SCAN_MAX). Unbekannte Kanaele werden\n
+    ignoriert.
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Mit einer kurzen Liste werden die verbleibenden Kanaele entsprechend\n
+  haeufiger gemessen. Nicht aufgefuehrte Kanaele werden von den Funktionen\n
+  weiterhin direkt gemessen.\n
+  Laeuft der Sequencer nicht mehr (leere Liste ohne Odometrie), muss er mit\n
+  AdcScanStart() neu gestartet werden.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Nur noch die Liniensensoren im Hintergrund messen
+  const unsigned char line [] = {IR_LEFT, IR_RIGHT};
+  AdcScanList (line, 2);
+  \endcode
+*****************************************************************************/
+void AdcScanList (
+  const unsigned char *list,
+  unsigned char n)
+{
+  unsigned char i, len = 0;
+  unsigned char sreg = SREG;
+
+  cli ();
+  for (i = 0; i < n && len < ADC_SCAN_MAX; i++)
+  {
+    if (list [i] >= (IR_RIGHT) && list [i] < ADC_CHANNELS)
+      adcscan [len++] = list [i];
+  }
+  adcscanlen = len;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert den letzten vom ADC Sequencer gemessenen Wert eines Kanals.
+
+  \param[in]
+  channel ADC-Kanal 0..5 (z.B. BATTERIE, IR_LEFT)
+
+  \return
+  10-Bit-Wert (Bereich 0..1023)
+
+  \par  Hinweis:
+  Der Wert wird gesperrt gegen den Interrupt gelesen. Mit adcseq[channel]\n
+  kann festgestellt werden, ob seit dem letzten Aufruf neu gemessen wurde.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  unsigned int links = AdcValue (IR_LEFT);
+  \endcode
+*****************************************************************************/
+unsigned int AdcValue (
+  unsigned char channel)
+{
+  unsigned int  data;
+  unsigned char sreg = SREG;
+
+  cli ();
+  data = adcvalue [channel];
+  SREG = sreg;
+  return data;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Stellt das Oversampling fuer einen ADC-Kanal ein.\n
+  Der Sequencer summiert dann 4^n Messungen auf, bevor er einen neuen Wert\n
+  ablegt. Die Wartezeit fuer den Aufrufer aendert sich dadurch nicht, es\n
+  sinkt nur die Rate, mit der neue Werte kommen.
+
+  \param[in]
+  channel ADC-Kanal 0..5 (z.B. IR_LEFT, WHEEL_RIGHT)
+  \param[in]
+  n 0 = aus, 1 = 4, 2 = 16, 3 = 64 Messungen (groessere Werte werden auf\n
+    ADC_OSR_MAX begrenzt)
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  AdcValue() und damit LineData() usw. liefern den Mittelwert (10 Bit),\n
+  AdcValueExt() den Wert mit 10 + n Bit. Jede Stufe bringt ein zusaetzliches\n
+  Bit, solange das Rauschen am Eingang mindestens etwa 1 LSB gross ist.\n
+  Die Odometrie zaehlt weiterhin mit jeder Einzelmessung.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Liniensensoren mit 16-fachem Oversampling (12 Bit)
+  AdcOversample (IR_LEFT, 2);
+  AdcOversample (IR_RIGHT, 2);
+  links = AdcValueExt (IR_LEFT);     // 0..4092
+  \endcode
+*****************************************************************************/
+void AdcOversample (
+  unsigned char channel,
+  unsigned char n)
+{
+  unsigned char sreg = SREG;
+
+  if (channel >= ADC_CHANNELS)
+    return;
+  if (n > ADC_OSR_MAX)
+    n = ADC_OSR_MAX;
+  cli ();
+  adcosr [channel] = n;
+  adcacc [channel] = 0;                 // neu aufsummieren
+  adccnt [channel] = 0;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert den letzten Wert eines ADC-Kanals mit erhoehter Aufloesung.
+
+  \param[in]
+  channel ADC-Kanal 0..5
+
+  \return
+  Wert mit 10 + n Bit, n siehe AdcOversample(). Ohne Oversampling\n
+  identisch mit AdcValue().
+
+  \par  Beispiel:
+  (siehe unter AdcOversample)
+*****************************************************************************/
+unsigned int AdcValueExt (
+  unsigned char channel)
+{
+  unsigned int  data;
+  unsigned char sreg = SREG;
+
+  cli ();
+  data = adcext [channel];
+  SREG = sreg;
+  return data;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Traegt eine Rueckruffunktion fuer einen ADC-Kanal ein.\n
+  Der ADC Sequencer ruft sie mit jedem neuen (gemittelten) Wert des Kanals\n
+  auf. So koennen Dienste wie die Batterieueberwachung im Hintergrund\n
+  laufen, ohne dass ihr Code in jedes Programm gelinkt wird.
+
+  \param[in]
+  channel ADC-Kanal 0..5
+  \param[in]
+  hook Funktion, die den 10-Bit-Wert bekommt. NULL = austragen.
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Die Funktion laeuft im Interrupt SIG_ADC und muss kurz sein.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  void Tasterwert (unsigned int wert)
+  {
+    if (wert < 1000)
+      gedrueckt = TRUE;
+  }
+  ...
+  AdcHook (SWITCH, Tasterwert);
+  \endcode
+*****************************************************************************/
+void AdcHook (
+  unsigned char channel,
+  void (*hook) (unsigned int))
+{
+  unsigned char sreg = SREG;
+
+  if (channel >= ADC_CHANNELS)
+    return;
+  cli ();
+  adchook [channel] = hook;             // 16-Bit-Zeiger, nicht atomar
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Prueft, ob der ADC Sequencer einen Kanal gerade misst.
+
+  \param[in]
+  channel ADC-Kanal 0..5
+
+  \return
+  TRUE, wenn der Kanal im Sequencer gemessen wird, sonst FALSE
+
+  \par  Hinweis:
+  Die Radsensoren werden nur bei laufender Odometrie (autoencode) gemessen,\n
+  der Taster-Kanal nicht, solange StartSwitch() den Interrupt INT1 nutzt.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  if (!AdcScanned (BATTERIE))
+    AdcScanStart ();
+  \endcode
+*****************************************************************************/
+unsigned char AdcScanned (
+  unsigned char channel)
+{
+  unsigned char i;
+
+  if (!adcscanon)
+    return FALSE;
+  if (channel == WHEEL_LEFT || channel == WHEEL_RIGHT)
+    return autoencode ? TRUE : FALSE;
+  if (channel == (SWITCH) && (GICR & (1 << INT1)))
+    return FALSE;
+  for (i = 0; i < adcscanlen; i++)
+    if (adcscan [i] == channel)
+      return TRUE;
+  return FALSE;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liest einen ADC-Kanal.\n
+  Misst der Sequencer den Kanal, wird der zwischengespeicherte Wert\n
+  zurueckgegeben. Sonst wird eine Wandlung gestartet und abgewartet.
+
+  \param[in]
+  mux Wert fuer ADMUX (Kanal und Referenz)
+  \param[in]
+  settle Wartezeit in 1/36kHz vor einer Wandlung, die nicht aus der\n
+         Kanalliste kommt (siehe Sleep())
+
+  \return
+  10-Bit-Wert (Bereich 0..1023)
+
+  \par  Hinweis:
+  Direkt nach AdcScanStart() wird auf die erste Messung des Kanals\n
+  gewartet (maximal einige Millisekunden).\n
+  Steht der Kanal nicht in der Kanalliste, misst ihn der laufende\n
+  Sequencer einmal als Einzelmessung (adconeshot) statt des naechsten\n
+  Listeneintrags, mit einer Einschwingmessung davor wie bei allen\n
+  Kanaelen. Die anderen Kanaele und die Odometrie laufen dabei weiter,\n
+  gewartet wird hoechstens einen Durchlauf (wenige 100 us).\n
+  Nur ohne Sequencer wird direkt gewandelt.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  unsigned int taster = AdcRead ((1 << REFS0) | SWITCH, 10);
+  \endcode
+*****************************************************************************/
+unsigned int AdcRead (
+  unsigned char mux,
+  unsigned char settle)
+{
+  unsigned char ch = mux & 0x07;
+  unsigned char seq;
+  unsigned int  data;
+
+  if (AdcScanned (ch))
+  {
+    while (!(adcvalid & (1 << ch)) && adcscanon)
+      ;                                 // erste Messung abwarten
+    if (adcscanon)
+      return AdcValue (ch);
+  }
+  else if (adcscanon)
+  {
+    if (settle)
+      Sleep (settle);                   // z.B. Taster-Kondensator laden
+    seq = adcseq [ch];
+    adconeshot = mux;                   // Einzelmessung im Sequencer
+    while (adcseq [ch] == seq && adcscanon)
+      ;
+    if (adcscanon)
+      return AdcValue (ch);
+  }
+
+  /*
+    Direkte Wandlung, der Sequencer laeuft nicht
+  */
+  AdcScanStop ();                       // SIG_ADC aus, falls sich der
+  adconeshot = ADC_ONESHOT_NONE;        // Sequencer selbst beendet hat
+  ADMUX = mux;
+  if (settle)
+    Sleep (settle);
+  ADCSRA |= (1 << ADSC);                // Starte AD-Wandlung
+  while (!(ADCSRA & (1 << ADIF)))       // Ende der AD-Wandlung abwarten
+    ;
+  ADCSRA |= (1 << ADIF);                // AD-Interupt-Flag zuruecksetzen
+  data = ADCL + (ADCH << 8);            // Ergebnis als 16-Bit-Wert
+  return data;
+}
+
+
+
 /****************************************************************************/
 /*!
   \brief
@@ -68,6 +492,9 @@
   \par
         Ubat[V] = 0,0055 * Battery ()
 
+  Ohne Fliesskomma liefert BatteryMv() aus battery.c den gefilterten Wert\n
+  in mV (adc * 11 / 2).
+
   \par  Beispiel:
   (Nur zur Demonstration der Parameter/Returnwerte)
   \code
@@ -83,26 +510,8 @@
 int   Battery (
   void)
 {
-  int   ec_bak = autoencode;            // Sichert aktuellen Zustand
-  int   data;
-
-  /*
-     Autoencode-Betrieb vom ADC-Wandler unterbinden.
-  */
-  autoencode = FALSE;
-
-  ADMUX = (1 << REFS0) | (1 << REFS1) | BATTERIE; // interne 2.56V Referenz
-                                                  // Ref. mit ext. Kapazitaet
-  ADCSRA |= (1 << ADSC);                // Starte AD-Wandlung
-  while (!(ADCSRA & (1 << ADIF)))       // Ende der AD-Wandlung abwarten
-    ;
-  ADCSRA |= (1 << ADIF);                // AD-Interupt-Flag zuruecksetzen
-  data = ADCL + (ADCH << 8);            // Ergebnis als 16-Bit-Wert
-  /*
-     Autoencode-Betrieb vom ADC-Wandler wiederherstellen.
-  */
-  autoencode = ec_bak;
-  return data;
+  return AdcRead ((1 << REFS0) | (1 << REFS1) | BATTERIE, 0); // interne 2.56V
+                                        // Ref. mit ext. Kapazitaet
 }
 
 
@@ -122,8 +531,9 @@ int   Battery (
   nichts
 
   \see
-  Die globale Variable autoencode wird temporaer auf FALSE gesetzt und am Ende\n
-  der Funktion mit dem alten Wert restauriert.
+  AdcRead(): Die Werte kommen aus dem ADC Sequencer, solange dieser die\n
+  Kanaele IR_LEFT und IR_RIGHT misst. Mit AdcOversample() werden sie dort\n
+  gemittelt.
 
   \par  Hinweis:
   Die Linien-Beleuchtungs-LED kann vorher mit der Funktion FrontLED()\n
@@ -144,39 +554,113 @@ int   Battery (
 void  LineData (
   unsigned int  *data)
 {
-  int   ec_bak = autoencode;            // Sichert aktuellen Zustand
-
   /*
-     Autoencode-Betrieb vom ADC-Wandler unterbinden.
+     Linken und rechten Linien-Sensor lesen. Referenz mit externer Kapazitaet
   */
-  autoencode = FALSE;
+  data [0] = AdcRead ((1 << REFS0) | IR_LEFT, 10);
+  data [1] = AdcRead ((1 << REFS0) | IR_RIGHT, 10);
+}
 
-  /*
-     Linken Linien-Sensor lesen
-  */
-  ADMUX = (1 << REFS0) | IR_LEFT;       // Referenz mit externer Kapazitaet
-  Sleep (10);
-  ADCSRA |= (1 << ADSC);                // Starte AD-Wandlung
-  while (!(ADCSRA & (1 << ADIF)))       // Ende der AD-Wandlung abwarten
-    ;
-  ADCSRA |= (1 << ADIF);                // AD-Interupt-Flag zuruecksetzen
-  data [0] = ADCL + (ADCH << 8);        // Ergebnis als 16-Bit-Wert
 
-  /*
-     Rechten Linien-Sensor lesen
-  */
-  ADMUX = (1 << REFS0) | IR_RIGHT;      // Referenz mit externer Kapazitaet
-  Sleep (10);
-  ADCSRA |= (1 << ADSC);                // Starte AD-Wandlung
-  while (!(ADCSRA & (1 << ADIF)))       // Ende der AD-Wandlung abwarten
-    ;
-  ADCSRA |= (1 << ADIF);                // AD-Interupt-Flag zuruecksetzen
-  data [1] = ADCL + (ADCH << 8);        // Ergebnis als 16-Bit-Wert
 
-  /*
-     Autoencode-Betrieb vom ADC-Wandler wiederherstellen.
-  */
-  autoencode = ec_bak;
+/****************************************************************************/
+/*!
+  \brief
+  Schaltet die Fremdlichtkompensation der Liniensensoren ein oder aus.\n
+  Der ADC Sequencer misst dann jeden Liniensensor zweimal kurz\n
+  hintereinander, einmal mit und einmal ohne FrontLED. Die Differenz\n
+  liefert LineDataComp().
+
+  \param[in]
+  status ON oder OFF
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Solange die Kompensation laeuft, schaltet der Sequencer die FrontLED.\n
+  Beim Ausschalten wird der vorherige Zustand der FrontLED wieder\n
+  hergestellt. Die Kanaele IR_LEFT und IR_RIGHT muessen in der Kanalliste\n
+  des Sequencers stehen (Voreinstellung). LineData() liefert weiterhin den\n
+  Wert mit eingeschalteter FrontLED.
+
+  \par  Beispiel:
+  (siehe unter LineDataComp)
+*****************************************************************************/
+void  LineCompensation (
+  unsigned char status)
+{
+  static unsigned char ledbak;
+
+  if (status && !linecomp)
+  {
+    ledbak = PORTD & FRONT_LED;         // FrontLED Zustand sichern
+    linecomp = TRUE;
+  }
+  else if (!status && linecomp)
+  {
+    linecomp = FALSE;
+    FrontLED (ledbak ? ON : OFF);
+  }
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liest die fremdlichtkompensierten Werte der Liniensensoren.\n
+  Die Werte sind die Differenz aus einer Messung mit und einer Messung\n
+  ohne FrontLED. Tages- oder Lampenlicht hebt sich dabei auf.
+
+  \param[out]
+  data Zeiger auf die gelesenen Daten:\n
+       data[0] linker Sensor,\n
+       data[1] rechter Sensor (Bereich -1023..1023, je heller der Boden,\n
+       desto groesser)
+
+  \return
+  TRUE, wenn seit dem letzten Aufruf fuer beide Sensoren neue Werte\n
+  gemessen wurden. FALSE, wenn die Werte veraltet sind (Kompensation aus\n
+  oder noch keine neue Messung).
+
+  \see
+  LineCompensation()
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  int data [2];
+  LineCompensation (ON);
+  while (1)
+  {
+    if (LineDataComp (data))
+    {
+      if (data [0] - data [1] > 10)
+        fahre_rechts ();
+    }
+  }
+  \endcode
+*****************************************************************************/
+unsigned char LineDataComp (
+  int *data)
+{
+  static unsigned char last [2];
+  unsigned char sreg = SREG;
+  unsigned char fresh;
+
+  cli ();
+  data [0] = linediff [LEFT];
+  data [1] = linediff [RIGHT];
+  fresh = linecomp &&
+          lineseq [LEFT] != last [LEFT] && lineseq [RIGHT] != last [RIGHT];
+  if (fresh)
+  {
+    last [LEFT]  = lineseq [LEFT];
+    last [RIGHT] = lineseq [RIGHT];
+  }
+  SREG = sreg;
+  return fresh;
 }
 
 
@@ -221,12 +705,6 @@ void  LineData (
 void  OdometryData (
   unsigned int  *data)
 {
-  int   ec_bak = autoencode;            // Sichert aktuellen Zustand
-
-  /*
-     Autoencode-Betrieb vom ADC-Wandler unterbinden.
-  */
-  autoencode = FALSE;
   /*
      Vorbereitung zum lesen der Odometrie-Sensoren.
   */
@@ -234,27 +712,8 @@ void  OdometryData (
   ODOMETRIE_LED_ON;                     // Odometrie-LED's einschalten
 
   /*
-     Linken Odometrie-Sensor lesen
-  */
-  ADMUX = (1 << REFS0) | WHEEL_LEFT;    // Referenz mit externer Kapazitaet
-  ADCSRA |= (1 << ADSC);                // Starte AD-Wandlung
-  while (!(ADCSRA & (1 << ADIF)))       // Ende der AD-Wandlung abwarten
-    ;
-  ADCSRA |= (1 << ADIF);                // AD-Interupt-Flag zuruecksetzen
-  data [0] = ADCL + (ADCH << 8);        // Ergebnis als 16-Bit-Wert
-
-  /*
-     Rechten Odometrie-Sensor lesen
-  */
-  ADMUX = (1 << REFS0) | WHEEL_RIGHT;   // Referenz mit externer Kapazitaet
-  ADCSRA |= (1 << ADSC);                // Starte AD-Wandlung
-  while (!(ADCSRA & (1 << ADIF)))       // Ende der AD-Wandlung abwarten
-    ;
-  ADCSRA |= (1 << ADIF);                // AD-Interupt-Flag zuruecksetzen
-  data [1] = ADCL + (ADCH << 8);        // Ergebnis als 16-Bit-Wert
-
-  /*
-     Autoencode-Betrieb vom ADC-Wandler wiederherstellen.
+     Linken und rechten Odometrie-Sensor lesen. Referenz mit ext. Kapazitaet
   */
-  autoencode = ec_bak;
+  data [0] = AdcRead ((1 << REFS0) | WHEEL_LEFT, 0);
+  data [1] = AdcRead ((1 << REFS0) | WHEEL_RIGHT, 0);
 }
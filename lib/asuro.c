@@ -13,7 +13,10 @@
             Behandelt werden folgende Interrupts:\n
             - SIG_OVERFLOW2   : Timer 2 (fest mit 36 kHz belegt)\n
             - SIG_INTERRUPT1  : Switches (Taster) im Interruptmode\n
-            - SIG_ADC         : Analog-Digital-Wandler
+            - SIG_ADC         : Analog-Digital-Wandler\n
+            Die Interrupts der seriellen Schnittstelle (SIG_UART_DATA,\n
+            SIG_UART_TRANS) stehen zusammen mit den Puffern in uart.c,\n
+            SIG_OVERFLOW0 (Regeltakt) steht mit dem Regler in ctrl.c.
 
   \par      Wichtiger Hinweis:
             Die Init()-Funktion muss von jedem Programm beim Start\n
@@ -43,6 +46,51 @@
             mitgelinkt
   \version  V004 - 15.11.2007 - m.a.r.v.i.n\n
             RIGHT_DIR und LEFT_DIR waren in der Init Funktion vertauscht
+  \version  V005 - 17.10.2026\n
+            Baudrate aus MY_UART_BAUD / MY_UART_U2X in myasuro.h berechnen
+  \version  V006 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            ADC Sequencer fuer alle Kanaele mit Zwischenspeicher adcvalue
+  \version  V007 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Oversampling je Kanal (AdcStore())
+  \version  V008 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Liniensensoren mit FrontLED an/aus messen (linecomp)
+  \version  V009 - 17.10.2026\n
+            Rueckruffunktionen adchook je ADC-Kanal
+  \version  V010 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Selbstkalibrierende Odometrie-Schwellwerte (odoauto)
+  \version  V011 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Zaehler enctick mit Drehrichtung
+  \version  V012 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Zeitstempel enctime fuer jeden Odometrie-Tick
+  \version  V013 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Rueckruffunktion enchook fuer jeden Odometrie-Tick
+  \version  V014 - 17.10.2026\n
+            +++ Init()\n
+            motorpwmtop zuruecksetzen (siehe MotorPwmMode())
+  \version  V015 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Einzelmessung adconeshot fuer AdcRead() statt den Sequencer\n
+            anzuhalten
+  \version  V016 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Angefangenes Paar der Fremdlichtkompensation beim Umschalten\n
+            von linecomp verwerfen
+  \version  V017 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Taster-Kondensator MY_SWITCH_SETTLE Wandlungen zusaetzlich laden\n
+            (eine Wandlung allein war kuerzer als das fruehere Sleep (10))
+  \version  V018 - 17.10.2026\n
+            +++ SIGNAL (SIG_ADC)\n
+            Zaehler fuer das Abklingen der Huellkurven je Rad. Mit einem\n
+            gemeinsamen Zaehler traf jede 16. Messung immer dasselbe Rad,\n
+            die Kurven vom linken Rad klangen nie ab.
           
 *****************************************************************************/
 /*****************************************************************************
@@ -85,7 +133,8 @@
 
   \see
   Die globale Variable autoencode fuer die automatische Bearbeitung der\n
-  Odometrie-ADC-Wandler wird hier auf FALSE gesetzt.
+  Odometrie-ADC-Wandler wird hier auf FALSE gesetzt.\n
+  Der ADC Sequencer wird hier gestartet (adcscanon).
 
   \par  Hinweis zur 36 kHz-Frequenz vom Timer 2
   Genau diese Frequenz wird von dem Empfaengerbaustein benoetigt und kann\n
@@ -127,12 +176,21 @@ void Init (
 
   /*
     Die serielle Schnittstelle wurde waerend der Boot-Phase schon
-    programmiert und gestartet. Hier werden die Parameter auf 2400 1N8 gesetzt.
+    programmiert und gestartet. Hier werden die Parameter auf 1N8 mit der
+    Baudrate MY_UART_BAUD (Original 2400) gesetzt. Mit SerBaud() kann die
+    Baudrate spaeter noch geaendert werden.
   */
+#if MY_UART_U2X
+  UCSRA = (1 << U2X);
+  #define INIT_UBRR UART_UBRR_U2X (MY_UART_BAUD)
+#else
   UCSRA = 0x00;
+  #define INIT_UBRR UART_UBRR (MY_UART_BAUD)
+#endif
   UCSRB = 0x00;
   UCSRC = 0x86; // 1 Stop Bit | No Parity | 8 Data Bit
-  UBRRL = 0xCF; // 2400bps @ 8.00MHz
+  UBRRH = (unsigned char) (INIT_UBRR >> 8);
+  UBRRL = (unsigned char) INIT_UBRR;  // 2400bps @ 8.00MHz: 0xCF
 
   /*
     Datenrichtung der I/O-Ports festlegen. Dies ist durch die Beschaltung der
@@ -148,14 +206,20 @@ void Init (
   /*
     PWM-Kanaele OC1A und OC1B auf 8-Bit einstellen.
     Sie werden fuer die Geschwindigkeitsvorgaben der Motoren benutzt.
+    Feinere Stufen oder 20 kHz gibt es mit MotorPwmMode().
   */
   TCCR1A = (1 << WGM10) | (1 << COM1A1) | (1 << COM1B1);
   TCCR1B = (1 << CS11);                 // tmr1-Timer mit MCU-Takt/8 betreiben.
+  motorpwmtop = 255;
 
   /*
-    Einstellungen des A/D-Wandlers auf MCU-Takt/64
+    Einstellungen des A/D-Wandlers auf MCU-Takt/64 und den ADC Sequencer
+    starten (siehe SIGNAL (SIG_ADC)). Er misst ab jetzt im Hintergrund die
+    Kanaele aus adcscan. Die Werte liefern Battery(), LineData(), PollSwitch().
   */
-  ADCSRA = (1 << ADEN) | (1 << ADPS2) | (1 << ADPS1);
+  adcscanon = TRUE;
+  ADMUX  = (1 << REFS0) | WHEEL_LEFT;
+  ADCSRA = (1 << ADEN) | (1 << ADIE) | (1 << ADSC) | (1 << ADPS2) | (1 << ADPS1);
 
   /*
     Sonstige Vorbereitungen.
@@ -241,6 +305,9 @@ SIGNAL (SIG_OVERFLOW2)
   Nach einer Bearbeitung im eigenen Hauptprogramm, muss also die Funktion\n
   StartSwitch() wieder Aufgerufen werden, um einen Tastendruck wieder ueber\n
   einen Interrupt zu erkennen.
+  Laeuft der Tastentreiber (SwitchInit()), misst der ADC Sequencer die\n
+  Taster ab jetzt wieder und meldet den Tastendruck entprellt als\n
+  SWITCH_PRESS.
 
   \par  Beispiel:
   (Nicht vorhanden)
@@ -257,8 +324,63 @@ SIGNAL (SIG_INTERRUPT1)
 /****************************************************************************/
 /*
   \brief
-  Interrupt-Funktion fuer den AD-Wandler. Kann ueber autoencode gesteuert\n
-  die Odometrie-Zaehler in encoder hochzaehlen.
+  Legt einen Messwert des ADC Sequencers ab. Mit Oversampling werden erst\n
+  4^adcosr[ch] Messungen aufsummiert.
+
+  \param[in]
+  ch ADC-Kanal
+  \param[in]
+  val 10-Bit-Messwert
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Aus der Summe S von 4^n Messungen ergibt S >> n einen Wert mit 10 + n Bit\n
+  (adcext) und S >> 2n den Mittelwert mit 10 Bit (adcvalue), jeweils\n
+  gerundet. Das Rauschen des Wandlers wirkt dabei als Dither. Bei maximal\n
+  64 Messungen (n = 3) passt die Summe in 16 Bit.
+  Ist fuer den Kanal eine Rueckruffunktion in adchook eingetragen, wird sie\n
+  mit dem neuen Wert aufgerufen.
+*****************************************************************************/
+static inline void AdcStore (
+  unsigned char ch,
+  unsigned int  val)
+{
+  unsigned char n = adcosr [ch];
+  unsigned int  sum;
+
+  if (n)
+  {
+    sum = adcacc [ch] + val;
+    if (++adccnt [ch] < (unsigned char) (1 << (2 * n)))
+    {
+      adcacc [ch] = sum;
+      return;                           // noch nicht genug Messungen
+    }
+    adcacc [ch] = 0;
+    adccnt [ch] = 0;
+    adcext [ch] = (sum + (1 << (n - 1))) >> n;
+    val = (sum + (1 << (2 * n - 1))) >> (2 * n);
+  }
+  else
+    adcext [ch] = val;
+  adcvalue [ch] = val;
+  adcseq [ch] ++;
+  adcvalid |= (1 << ch);
+  if (adchook [ch])
+    adchook [ch] (val);                 // z.B. Batterieueberwachung
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Interrupt-Funktion fuer den AD-Wandler. Arbeitet als Sequencer, der\n
+  reihum alle Kanaele aus adcscan misst und die Ergebnisse in adcvalue\n
+  ablegt. Ueber autoencode gesteuert werden zusaetzlich die Radsensoren\n
+  gemessen und die Odometrie-Zaehler in encoder hochgezaehlt.
 
   \param
   keine
@@ -267,48 +389,279 @@ SIGNAL (SIG_INTERRUPT1)
   nichts
 
   \see
-  Die globale Variable autoencode wird hier ausgewertet. Ist sie nicht FALSE,\n
-  dann wird der AD-Wandler-Wert zum Zaehlen der Odometriewerte in der globalen\n
-  Variablen encoder benutzt.\n
-  Es wird auch der AD-Wandler-Kanal auf die 'andere' Seite der Odometrie\n
-  umgeschaltete und der AD-Wandler neu gestartet.\n
-  Somit wird erreicht, dass zumindest die Odometriemessung automatisch erfolgt.
-  
+  Die globalen Variablen adcscan, adcscanlen, adcscanon und autoencode\n
+  werden hier ausgewertet. AdcScanStart() in adc.c startet die erste Wandlung.
+
+  \par  Funktionsweise:
+  Der Wandler laeuft im Single-Conversion-Mode und wird am Ende dieser\n
+  Funktion neu gestartet. Dadurch gehoert jeder Messwert sicher zu dem Kanal,\n
+  der gerade in ADMUX steht (im 'free running'-Mode war immer schon die\n
+  naechste Wandlung mit dem alten Kanal gestartet).\n
+  Die Reihenfolge ist immer in 4 Schritten:\n
+  0: Radsensor links, 1: Radsensor rechts,\n
+  2: Kanal aus adcscan einschwingen lassen (Wert wird verworfen),\n
+  3: Kanal aus adcscan messen.\n
+  Die Einschwingmessung wird benoetigt, da die Batteriemessung die interne\n
+  2.56V Referenz benutzt und der Taster-Kanal erst ueber SWITCH_ON geladen\n
+  werden muss. Fuer den Taster-Kanal wird Schritt 2 MY_SWITCH_SETTLE mal\n
+  wiederholt, damit der Kondensator wie frueher mit Sleep (10) (278 us)\n
+  laden kann. Ohne autoencode entfallen die Schritte 0 und 1.\n
+  Der Taster-Kanal wird uebersprungen, solange der Interrupt INT1 ueber\n
+  StartSwitch() eingeschaltet ist, da der Port dann als Eingang arbeitet.\n
+  Mit ADC-Takt clk/64 (125 kHz) dauert eine Wandlung etwa 104 us.\n
+  Die Odometrie zaehlt immer mit jeder einzelnen Messung, auch wenn fuer\n
+  die Radsensoren Oversampling eingestellt ist.
+  Neben encoder[] (nur aufwaerts, 16 Bit) wird enctick[] mit der\n
+  Drehrichtung aus MotorDir() gezaehlt (32 Bit mit Vorzeichen) und der\n
+  Zeitpunkt jedes Ticks in enctime abgelegt (fuer EncoderSpeedUpdate()).\n
+  Ist enchook eingetragen, wird die Funktion mit jedem Tick aufgerufen\n
+  (z.B. Positionsberechnung in pose.c).\n
+  Mit EncoderAutoThreshold() folgen je Rad zwei Huellkurven dem hellsten\n
+  und dunkelsten Wert der Encoderscheibe. Die Schwellen liegen dann bei\n
+  3/8 und 5/8 zwischen den Kurven. Der Aufwand ist fest: ein paar\n
+  Vergleiche, Shifts und Additionen je Messung, keine Schleife.
+  Mit LineCompensation() werden die Liniensensoren zweimal hintereinander\n
+  gemessen: in Schritt 2 wird die FrontLED fuer die erste Messung ein- und\n
+  fuer die zweite ausgeschaltet. Die Differenz steht (mit dem Oversampling\n
+  des Kanals gemittelt) in linediff.\n
+  Steht in adconeshot eine Einzelmessung an (AdcRead() fuer einen Kanal,\n
+  der nicht in adcscan steht), belegt sie die Schritte 2 und 3 statt des\n
+  naechsten Listeneintrags. Der Wert landet ohne Oversampling und\n
+  Rueckruffunktion in adcvalue, adcseq wird hochgezaehlt.
+
   \par  Beispiel:
   (Nicht vorhanden)
 *****************************************************************************/
 SIGNAL (SIG_ADC)
 {
-  static unsigned char tmp [2], flag [2], toggle = FALSE;
-  unsigned char dval, lval; 
+  static unsigned char flag [2], slot, aux, dark, paircnt [2], envcnt [2], shot;
+  static unsigned char comp, settle;
+  static signed char   encdir [2] = {1, 1};
+  static unsigned int  litval;
+  static long          pairacc [2];
+  unsigned char n;
+  unsigned char ch, side;
+  unsigned int  val, dval, lval, v, mid, band;
+
+  ch  = ADMUX & 0x07;
+  val = ADCL;                           // ADCL muss zuerst gelesen werden
+  val += (ADCH << 8);
+
+  if (!adcscanon)
+    return;                             // Sequencer angehalten
+  if (adconeshot == ADC_ONESHOT_NONE)
+    shot = FALSE;                       // z.B. nach AdcScanStart()
+  if (linecomp != comp)
+  {
+    /*
+      LineCompensation() wurde umgeschaltet: ein halbes Paar oder halbe
+      Summen von vorher gehoeren nicht zu den neuen Messungen.
+    */
+    comp = linecomp;
+    dark = FALSE;
+    pairacc [LEFT] = pairacc [RIGHT] = 0;
+    paircnt [LEFT] = paircnt [RIGHT] = 0;
+  }
+
+  if (!shot && (ch == WHEEL_LEFT || ch == WHEEL_RIGHT))
+    slot = (ch == WHEEL_LEFT) ? 0 : 1;  // Radkanal bestimmt den Schritt
 
-  if (autoencode)
+  if (slot < 2)
   {
-    tmp [toggle] = ADCH;
-    if (toggle)
-    {     
-      ADMUX = (1 << ADLAR) | (1 << REFS0) | WHEEL_RIGHT;
-      dval = MY_ODO_DARK_VALUE_R;
-      lval = MY_ODO_LIGHT_VALUE_R;
+    AdcStore (ch, val);
+    if (autoencode)
+    {
+      /*
+        Schwellwerte aus myasuro.h sind 8-Bit-Werte
+      */
+      if (ch == WHEEL_LEFT)
+      {
+        side = LEFT;
+        dval = MY_ODO_DARK_VALUE_L << 2;
+        lval = (MY_ODO_LIGHT_VALUE_L << 2) + 3;
+      }
+      else
+      {
+        side = RIGHT;
+        dval = MY_ODO_DARK_VALUE_R << 2;
+        lval = (MY_ODO_LIGHT_VALUE_R << 2) + 3;
+      }
+      if (odoauto)
+      {
+        /*
+          Huellkurven: sofort auf neue Extremwerte, sonst alle 16 Messungen
+          langsam in Richtung Messwert. Die Schwellen liegen bei 3/8 und
+          5/8 des Kontrastes, aber mindestens MY_ODO_MIN_CONTRAST / 2 um
+          die Mitte, damit Rauschen bei stehendem Rad nicht zaehlt.
+        */
+        v = val << 4;
+        envcnt [side] ++;
+        if (v > odomax [side])
+          odomax [side] = v;
+        else if (!(envcnt [side] & 0x0F))
+          odomax [side] -= (odomax [side] - v) >> MY_ODO_ENV_DECAY;
+        if (v < odomin [side])
+          odomin [side] = v;
+        else if (!(envcnt [side] & 0x0F))
+          odomin [side] += (v - odomin [side]) >> MY_ODO_ENV_DECAY;
+
+        if (odomax [side] < odomin [side] + (MY_ODO_MIN_CONTRAST << 4))
+        {
+          dval = 0;                     // zu wenig Kontrast: nicht zaehlen
+          lval = 1023;
+        }
+        else
+        {
+          mid  = (odomax [side] >> 1) + (odomin [side] >> 1);
+          band = (odomax [side] - odomin [side]) >> 3;
+          if (band < (MY_ODO_MIN_CONTRAST << 3))
+            band = MY_ODO_MIN_CONTRAST << 3; // Hysterese mind. +-MIN/2
+          dval = (mid - band) >> 4;
+          lval = (mid + band) >> 4;
+        }
+      }
+      /*
+        Drehrichtung aus den Richtungsbits von MotorDir(). Bei BREAK und
+        FREE bleibt die letzte Richtung (auslaufendes Rad).
+      */
+      n = ((side == LEFT) ? PORTD : PORTB) & (FWD | RWD);
+      if (n == FWD)
+        encdir [side] = 1;
+      else if (n == RWD)
+        encdir [side] = -1;
+
+      if (((val < dval) && (flag [side] == TRUE)) ||
+          ((val > lval) && (flag [side] == FALSE)))
+      {
+        encoder [side] ++;
+        enctick [side] += encdir [side];
+        enctime [side] = ((unsigned int) timebase << 8) | count36kHz;
+        flag [side] = !flag [side];
+        if (enchook)
+          enchook (side, encdir [side]);
+      }
     }
-    else
-    {     
-      ADMUX = (1 << ADLAR) | (1 << REFS0) | WHEEL_LEFT;
-      dval = MY_ODO_DARK_VALUE_L;
-      lval = MY_ODO_LIGHT_VALUE_L;
+  }
+  else if (slot == 3 && shot)
+  {
+    adcvalue [ch] = val;                // Einzelmessung fuer AdcRead()
+    adcseq [ch] ++;
+    adcvalid |= (1 << ch);
+    adconeshot = ADC_ONESHOT_NONE;
+    shot = FALSE;
+  }
+  else if (slot == 3)
+  {
+    if (ch == (SWITCH))
+    {
+      if (!(GICR & (1 << INT1)))
+      {
+        SWITCH_OFF;
+        AdcStore (ch, val);
+      }
     }
-    
-    if ((tmp [toggle] < dval) && (flag[toggle] == TRUE))
+    else if (linecomp && (ch == (IR_LEFT) || ch == (IR_RIGHT)))
     {
-      encoder [toggle] ++;
-      flag [toggle] = FALSE;
+      /*
+        Liniensensor mit Fremdlichtkompensation: erst mit, dann ohne
+        FrontLED messen. Passt der LED-Zustand nicht (FrontLED() wurde
+        dazwischen aufgerufen), wird das Paar verworfen.
+      */
+      if (((PORTD & FRONT_LED) == 0) != dark)
+        dark = FALSE;
+      else if (!dark)
+      {
+        litval = val;
+        AdcStore (ch, val);             // LineData() liefert den hellen Wert
+        dark = TRUE;
+      }
+      else
+      {
+        /*
+          Differenz mit dem Oversampling des Kanals mitteln (4^n Paare)
+        */
+        side = (ch == (IR_LEFT)) ? LEFT : RIGHT;
+        n = adcosr [ch];
+        pairacc [side] += (int) litval - (int) val;
+        if (++paircnt [side] >= (unsigned char) (1 << (2 * n)))
+        {
+          linediff [side] = n ? (pairacc [side] + (1L << (2 * n - 1))) >> (2 * n)
+                              : pairacc [side];
+          lineseq [side] ++;
+          pairacc [side] = 0;
+          paircnt [side] = 0;
+        }
+        dark = FALSE;
+      }
+      if (dark)
+        aux --;                         // gleicher Kanal noch einmal
     }
-    if ((tmp [toggle] > lval) && (flag [toggle] == FALSE))
+    else
+      AdcStore (ch, val);
+    if (++aux >= adcscanlen)
+      aux = 0;
+  }
+
+  /*
+    Naechsten Schritt bestimmen
+  */
+  if (slot == 2 && settle)
+  {
+    settle --;                          // Taster-Kondensator laedt weiter
+    ADCSRA |= (1 << ADSC);
+    return;
+  }
+  slot = (slot + 1) & 3;
+  if (slot < 2 && !autoencode)
+    slot = 2;
+  if (slot >= 2 && adcscanlen == 0 && adconeshot == ADC_ONESHOT_NONE)
+  {
+    if (!autoencode)
     {
-      encoder [toggle] ++;
-      flag [toggle] = TRUE;
+      adcscanon = FALSE;                // nichts mehr zu tun
+      return;
     }
-    toggle ^= 1;
+    slot = 0;
   }
+  if (aux >= adcscanlen)
+    aux = 0;
+
+  switch (slot)
+  {
+    case 0:
+      ADMUX = (1 << REFS0) | WHEEL_LEFT;
+      break;
+    case 1:
+      ADMUX = (1 << REFS0) | WHEEL_RIGHT;
+      break;
+    case 2:
+      settle = 0;
+      if (adconeshot != ADC_ONESHOT_NONE)
+      {
+        ADMUX = adconeshot;             // Einzelmessung, Liste wartet
+        shot  = TRUE;
+        break;
+      }
+      ch = adcscan [aux];
+      if (ch == (BATTERIE))
+        ADMUX = (1 << REFS0) | (1 << REFS1) | ch; // interne 2.56V Referenz
+      else
+        ADMUX = (1 << REFS0) | ch;
+      if (ch == (SWITCH) && !(GICR & (1 << INT1)))
+      {
+        DDRD |= SWITCHES;               // Taster-Kondensator laden
+        SWITCH_ON;
+        settle = MY_SWITCH_SETTLE;
+      }
+      if (linecomp && (ch == (IR_LEFT) || ch == (IR_RIGHT)))
+      {
+        if (dark)                       // Fototransistor schwingt waehrend
+          PORTD &= ~FRONT_LED;          // der Einschwingmessung ein
+        else
+          PORTD |= FRONT_LED;
+      }
+      break;
+  }                                     // Schritt 3: Kanal bleibt
+  ADCSRA |= (1 << ADSC);                // naechste Wandlung starten
 }
 
@@ -0,0 +1,403 @@
+/****************************************************************************/
+/*!
+  \file     battery.c
+
+  \brief    Batterieueberwachung im Hintergrund.\n
+            Gefilterte Batteriespannung in mV, kleinste Spannung unter Last,\n
+            Warn- und Abschaltschwelle mit Rueckruffunktion und Begrenzung\n
+            der Motor-PWM bei leerer Batterie.
+
+  \see      Zustaende BATTERY_xxx in battery.h\n
+            MY_BATTERY_AVG, MY_BATTERY_HYST in myasuro.h
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            Begrenzung von OCR1A/OCR1B auch bei MotorPwmMode() != 8 Bit
+  \version  V003 - 17.10.2026\n
+            +++ BatteryCompensate()  NEU\n
+            Motor-PWM mit Nennspannung / Batteriespannung angleichen
+  \version  V004 - 17.10.2026\n
+            BatteryHook() schreibt nur noch die Spannung nach motorvmv,\n
+            die Division fuer den Faktor laeuft in MotorSpeed()
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "asuro.h"
+#include "myasuro.h"
+#include "battery.h"
+
+/*
+  Umrechnung ADC-Wert -> mV: Ubat = 0.0055 V * adc = adc * 11 / 2 mV
+*/
+#define BATTERY_MV(adc) ((unsigned int) (((unsigned long) (adc) * 11) / 2))
+static unsigned int  ring [MY_BATTERY_AVG]; // letzte ADC-Werte
+static unsigned int  sum;               // Summe ueber ring
+static unsigned char idx;
+static unsigned char filled;
+static volatile unsigned int  battmv;   // gleitender Mittelwert in mV
+static volatile unsigned int  battmin = 0xFFFF;
+static volatile unsigned char battlevel = BATTERY_OK;
+static unsigned int  battwarn, battcut;
+static unsigned char cutpwm = 255;
+static void (*battcallback) (unsigned char);
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Rueckruffunktion fuer den Batteriekanal des ADC Sequencers.\n
+  Laeuft im Interrupt SIG_ADC.
+
+  \param[in]
+  adc neuer 10-Bit-Wert der Batteriespannung
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Der Mittelwert wird ueber die ADC-Werte gebildet (die Summe passt fuer\n
+  bis zu 64 Werte in 16 Bit) und erst danach in mV umgerechnet.\n
+  Die Warnung wird mit Hysterese zurueckgenommen, die Abschaltung bleibt\n
+  bis zum naechsten BatteryMonitor() bestehen. Sonst wuerde die Spannung\n
+  nach dem Begrenzen der Motoren wieder steigen und die Motoren wieder\n
+  freigeben.\n
+  Fuer BatteryCompensate() wird der Mittelwert nur nach motorvmv kopiert.\n
+  Den Faktor rechnet MotorSpeed() daraus; eine 32-Bit-Division wuerde\n
+  hier laenger dauern als ein Takt vom 36 kHz Timer.
+*****************************************************************************/
+static void BatteryHook (
+  unsigned int adc)
+{
+  unsigned char i, level;
+  unsigned int  mv;
+
+  if (!filled)
+  {
+    for (i = 0; i < MY_BATTERY_AVG; i++)
+      ring [i] = adc;                   // mit dem ersten Wert vorbelegen
+    sum = adc * MY_BATTERY_AVG;
+    filled = TRUE;
+  }
+  else
+  {
+    sum -= ring [idx];
+    sum += adc;
+    ring [idx] = adc;
+    idx = (idx + 1) & (MY_BATTERY_AVG - 1);
+  }
+  mv = BATTERY_MV (sum / MY_BATTERY_AVG);
+  battmv   = mv;
+  motorvmv = mv;
+
+  if ((OCR1A || OCR1B) && mv < battmin)
+    battmin = mv;                       // Minimum unter Last
+
+  level = battlevel;
+  if (mv < battcut)
+    level = BATTERY_CUTOFF;
+  else if (level == BATTERY_OK && mv < battwarn)
+    level = BATTERY_WARN;
+  else if (level == BATTERY_WARN && mv >= battwarn + MY_BATTERY_HYST)
+    level = BATTERY_OK;
+
+  if (level == BATTERY_CUTOFF && cutpwm != 255)
+  {
+    unsigned int ocr = MotorPwmOcr (cutpwm * 257U);
+
+    pwmlimit = cutpwm;
+    if (OCR1A > ocr)
+      OCR1A = ocr;
+    if (OCR1B > ocr)
+      OCR1B = ocr;
+  }
+
+  if (level != battlevel)
+  {
+    battlevel = level;
+    if (battcallback)
+      battcallback (level);
+  }
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Startet die Batterieueberwachung im Hintergrund.
+
+  \param[in]
+  warn Warnschwelle in mV
+  \param[in]
+  cutoff Abschaltschwelle in mV
+  \param[in]
+  callback Funktion, die bei jedem Zustandswechsel mit BATTERY_OK,\n
+           BATTERY_WARN oder BATTERY_CUTOFF aufgerufen wird. NULL = keine,\n
+           dann nur BatteryLevel() abfragen.
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Die Rueckruffunktion laeuft im Interrupt SIG_ADC und muss kurz sein\n
+  (z.B. nur ein Flag setzen oder die StatusLED schalten).\n
+  Steht BATTERIE nicht in der Kanalliste des ADC Sequencers, wird der\n
+  Kanal angehaengt. Ein erneuter Aufruf setzt auch den Zustand\n
+  BATTERY_CUTOFF und die PWM-Begrenzung zurueck.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  void Batteriealarm (unsigned char level)
+  {
+    StatusLED (level == BATTERY_OK ? GREEN : RED);
+  }
+  ...
+  BatteryMonitor (4600, 4400, Batteriealarm);
+  BatteryCutoffPwm (0);                 // Motoren bei leerer Batterie aus
+  \endcode
+*****************************************************************************/
+void BatteryMonitor (
+  unsigned int warn,
+  unsigned int cutoff,
+  void (*callback) (unsigned char level))
+{
+  unsigned char sreg = SREG;
+
+  AdcHook (BATTERIE, 0);                // Hook waehrend der Aenderung aus
+
+  battwarn     = warn;
+  battcut      = cutoff;
+  battcallback = callback;
+  battlevel    = BATTERY_OK;
+  battmin      = 0xFFFF;
+  filled       = FALSE;
+  idx          = 0;
+  pwmlimit     = 255;
+
+  cli ();
+  if (!AdcScanned (BATTERIE) && adcscanlen < ADC_SCAN_MAX)
+    adcscan [adcscanlen++] = BATTERIE;
+  SREG = sreg;
+  if (!adcscanon)
+    AdcScanStart ();
+
+  AdcHook (BATTERIE, BatteryHook);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Beendet die Batterieueberwachung und hebt die PWM-Begrenzung auf.
+
+  \param
+  keine
+
+  \return
+  nichts
+*****************************************************************************/
+void BatteryMonitorStop (
+  void)
+{
+  AdcHook (BATTERIE, 0);
+  pwmlimit = 255;
+  motorvmv = 0;                         // kein Messwert, kein Ausgleich
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert die gefilterte Batteriespannung in mV.
+
+  \param
+  keine
+
+  \return
+  Gleitender Mittelwert ueber MY_BATTERY_AVG Werte in mV.\n
+  Laeuft die Ueberwachung nicht, wird einmal mit Battery() gemessen.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  PrintInt (BatteryMv ());              // z.B. 4950
+  \endcode
+*****************************************************************************/
+unsigned int BatteryMv (
+  void)
+{
+  unsigned int  mv;
+  unsigned char sreg = SREG;
+
+  if (adchook [BATTERIE] != BatteryHook || !filled)
+    return BATTERY_MV (Battery ());
+  cli ();
+  mv = battmv;
+  SREG = sreg;
+  return mv;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert die kleinste gefilterte Batteriespannung, die bei laufenden\n
+  Motoren (PWM > 0) gemessen wurde.
+
+  \param
+  keine
+
+  \return
+  Spannung in mV, 0xFFFF solange noch nicht gemessen.
+*****************************************************************************/
+unsigned int BatteryMinMv (
+  void)
+{
+  unsigned int  mv;
+  unsigned char sreg = SREG;
+
+  cli ();
+  mv = battmin;
+  SREG = sreg;
+  return mv;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Setzt das Minimum von BatteryMinMv() zurueck.
+
+  \param
+  keine
+
+  \return
+  nichts
+*****************************************************************************/
+void BatteryMinReset (
+  void)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  battmin = 0xFFFF;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert den Zustand der Batterieueberwachung.
+
+  \param
+  keine
+
+  \return
+  BATTERY_OK, BATTERY_WARN oder BATTERY_CUTOFF
+*****************************************************************************/
+unsigned char BatteryLevel (
+  void)
+{
+  return battlevel;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Legt fest, auf welchen Wert die Motor-PWM bei Erreichen der\n
+  Abschaltschwelle begrenzt wird.
+
+  \param[in]
+  pwm Maximaler PWM-Wert fuer MotorSpeed() (0 = Motoren aus).\n
+      255 = keine Begrenzung (Voreinstellung).
+
+  \return
+  nichts
+
+  \par  Beispiel:
+  (siehe unter BatteryMonitor)
+*****************************************************************************/
+void BatteryCutoffPwm (
+  unsigned char pwm)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  cutpwm = pwm;
+  if (battlevel == BATTERY_CUTOFF)
+    pwmlimit = pwm;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Gleicht die Motor-PWM an die Batteriespannung an: MotorSpeed() und\n
+  MotorSpeed16() werden mit Nennspannung / Batteriespannung\n
+  malgenommen. So faehrt MotorSpeed (150, 150) mit vollem und mit fast\n
+  leerem Akku etwa gleich schnell.
+
+  \param[in]
+  nominal Nennspannung in mV (z.B. MY_BATTERY_NOMINAL), 0 = aus
+
+  \return
+  nichts
+
+  \see
+  motorvnom, motorvmv, MY_BATTERY_NOMINAL in myasuro.h
+
+  \par  Hinweis:
+  Laeuft die Batterieueberwachung noch nicht, wird sie mit\n
+  BatteryMonitor (0, 0, NULL) gestartet (ohne Schwellen). Benutzt wird\n
+  der gefilterte Wert von BatteryMv(), MotorSpeed() selbst misst nicht.\n
+  Der Faktor wird auf 0.5..1.5 begrenzt, die PWM auf 255 und pwmlimit.\n
+  Gerechnet wird er in MotorSpeed() und nur, wenn sich die Spannung\n
+  geaendert hat.\n
+  Bei voller PWM ist also keine Reserve mehr da: ueber etwa\n
+  255 * Batteriespannung / Nennspannung wird die Geschwindigkeit nicht\n
+  mehr ausgeglichen.\n
+  Der Faktor wirkt beim Aufruf von MotorSpeed(). Ein Programm, das die\n
+  Geschwindigkeit nur einmal setzt, wird waehrend der Fahrt nicht\n
+  nachgefuehrt; die Geschwindigkeitsregelung (ctrl.c) setzt sie in jedem\n
+  Takt neu und profitiert auch davon (gleiche Vorsteuerung bei jeder\n
+  Spannung).
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  BatteryCompensate (MY_BATTERY_NOMINAL);
+  MotorDir (FWD, FWD);
+  MotorSpeed (150, 150);                // bei 4.4 V wie 164, bei 5.4 V wie 133
+  \endcode
+*****************************************************************************/
+void BatteryCompensate (
+  unsigned int nominal)
+{
+  unsigned char sreg;
+
+  if (nominal && adchook [BATTERIE] != BatteryHook)
+    BatteryMonitor (0, 0, 0);
+  sreg = SREG;
+  cli ();
+  motorvnom = nominal;
+  SREG = sreg;
+}
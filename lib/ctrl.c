@@ -0,0 +1,586 @@
+/****************************************************************************/
+/*!
+  \file     ctrl.c
+
+  \brief    Geschwindigkeitsregelung der Raeder im Hintergrund.\n
+            Fester Regeltakt ueber Timer 0, je Rad ein PID-Regler mit\n
+            Vorsteuerung und Anti-Windup. Sollwerte in mm/s.
+
+  \see      CTRL_HZ in ctrl.h\n
+            MY_CTRL_KP, MY_CTRL_KI, MY_CTRL_KD, MY_CTRL_FF_OFFSET,\n
+            MY_CTRL_FF_GAIN in myasuro.h
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            +++ CtrlHook(), CtrlActive()  NEU\n
+            Rueckruffunktion je Regeltakt (z.B. Bewegungsablauf in motion.c)
+  \version  V003 - 17.10.2026\n
+            Vorsteuerung ueber motorffgain, wenn die Motorkennlinie aktiv ist
+  \version  V004 - 17.10.2026\n
+            Ausgabe mit MotorSpeed16(), die Nachkommastellen des Reglers\n
+            gehen nicht mehr verloren
+  \version  V005 - 17.10.2026\n
+            +++ MotorSlew()  NEU\n
+            Rampe der Motoren im selben Takt, auch ohne Regelung
+  \version  V006 - 17.10.2026\n
+            +++ CtrlBackground()  NEU\n
+            Rueckruffunktion je Takt, auch ohne Regelung (z.B. pose.c)
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "asuro.h"
+#include "myasuro.h"
+#include "ctrl.h"
+
+/*
+  Timer 0 mit MCU-Takt/256 = 31250 Hz, 250 Schritte bis zum Ueberlauf
+*/
+#define CTRL_TCNT0    (256 - (F_CPU / 256 / CTRL_HZ))
+#define CTRL_IMAX     (255L << 8)       // Grenze fuer den Integralanteil
+#define CTRL_UMAX     (255L << 8)       // Grenze fuer den Ausgang (PWM * 256)
+
+static volatile int  target [2];        // Sollwerte in mm/s
+static int           lastspeed [2];     // Istwert aus dem letzten Takt
+static long          integ [2];         // Integralanteil * 256
+static int           output [2];        // PWM mit Vorzeichen
+static unsigned char started [2];       // erste Messung nach dem Anfahren da
+static volatile int  gainp = MY_CTRL_KP;
+static volatile int  gaini = MY_CTRL_KI;
+static volatile int  gaind = MY_CTRL_KD;
+static volatile unsigned char busy;
+static volatile unsigned char ctrlon;   // Regler aktiv (CtrlInit)
+static void (* volatile hook) (void);   // je Regeltakt vor dem Regler
+static void (* volatile bghook) (void); // je Takt, auch ohne Regelung
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Ein Regelschritt fuer beide Raeder.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  u = Vorsteuerung + (KP * e + I + KD * (v_alt - v)) / 256\n
+  u wird als PWM * 256 gerechnet und mit MotorSpeed16() ausgegeben. Mit\n
+  MotorPwmMode() (9/10 Bit, 20 kHz) kommen so mehr Stufen am Motor an.\n
+  Mit Motorkennlinie (motorlin) ist die Ausgabe eine Vorgabe fuer\n
+  MotorSpeed(), die Vorsteuerung dann einfach v * 256 / motorvmax ohne\n
+  Anlauf-PWM.\n
+  Der D-Anteil wirkt auf den Istwert, damit ein Sollwertsprung keinen\n
+  Stoss erzeugt. Der I-Anteil wird nicht weiter aufintegriert, solange\n
+  der Ausgang in der Begrenzung steht und die Abweichung in dieselbe\n
+  Richtung zeigt (Anti-Windup).\n
+  Nach dem Anfahren liefert EncoderSpeedMm() erst nach zwei Ticks einen\n
+  Wert. Bis dahin faehrt das Rad nur mit der Vorsteuerung, sonst wuerde\n
+  der Regler in dieser Zeit auf volle PWM laufen und ueberschwingen.
+*****************************************************************************/
+static void CtrlTick (
+  void)
+{
+  unsigned char side, dir [2];
+  unsigned int  pwm [2];
+  int  tgt, speed, e;
+  long u;
+
+  EncoderSpeedUpdate ();
+  if (hook)
+    hook ();                            // kann neue Sollwerte setzen
+
+  for (side = LEFT; side <= RIGHT; side++)
+  {
+    tgt   = target [side];
+    speed = EncoderSpeedMm (side);
+
+    if (tgt == 0)
+    {
+      integ [side]   = 0;
+      started [side] = FALSE;
+      u = 0;
+    }
+    else
+    {
+      if (speed != 0)
+        started [side] = TRUE;
+
+      if (motorlin)
+        u = (long) tgt * motorffgain;
+      else
+      {
+        u = (long) tgt * MY_CTRL_FF_GAIN;
+        u += (tgt > 0) ? ((long) MY_CTRL_FF_OFFSET << 8) : -((long) MY_CTRL_FF_OFFSET << 8);
+      }
+      e = tgt - speed;
+      if (started [side])
+      {
+        u += (long) gainp * e + integ [side] +
+             (long) gaind * (lastspeed [side] - speed);
+        if (!((u >= CTRL_UMAX && e > 0) || (u <= -CTRL_UMAX && e < 0)))
+        {
+          integ [side] += (long) gaini * e;
+          if (integ [side] > CTRL_IMAX)
+            integ [side] = CTRL_IMAX;
+          else if (integ [side] < -CTRL_IMAX)
+            integ [side] = -CTRL_IMAX;
+        }
+      }
+      if (u > CTRL_UMAX)
+        u = CTRL_UMAX;
+      else if (u < -CTRL_UMAX)
+        u = -CTRL_UMAX;
+    }
+    lastspeed [side] = speed;
+    output [side]    = (int) (u / 256);
+
+    if (u > 0)
+    {
+      dir [side] = FWD;
+      pwm [side] = (unsigned int) u + (unsigned int) (u >> 8);   // 255 * 256 -> 65535
+    }
+    else if (u < 0)
+    {
+      u = -u;
+      dir [side] = RWD;
+      pwm [side] = (unsigned int) u + (unsigned int) (u >> 8);
+    }
+    else
+    {
+      dir [side] = BREAK;
+      pwm [side] = 0;
+    }
+  }
+
+  /*
+    MotorDir() nur bei einem Richtungswechsel, da PORTB/PORTD auch vom
+    Hauptprogramm geschrieben werden (StatusLED(), FrontLED()).
+  */
+  if ((PORTD & (FWD | RWD)) != dir [LEFT] || (PORTB & (FWD | RWD)) != dir [RIGHT])
+    MotorDir (dir [LEFT], dir [RIGHT]);
+  MotorSpeed16 (pwm [LEFT], pwm [RIGHT]);
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Interrupt-Funktion fuer Timer-0-Ueberlauf. Regeltakt mit CTRL_HZ.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par
+  Der Regelschritt laeuft mit wieder freigegebenen Interrupts, damit der\n
+  36 kHz-Interrupt von Timer 2 (Zeitfunktionen, RC5) und der ADC Sequencer\n
+  waehrend der Rechnung nicht ausfallen. busy verhindert, dass sich zwei\n
+  Regelschritte ueberholen.\n
+  Die Rampe aus MotorSlew() laeuft nach dem Regler im selben Takt, so\n
+  wirkt sie auch auf dessen Ausgabe. Danach folgt die Funktion aus\n
+  CtrlBackground().
+*****************************************************************************/
+SIGNAL (SIG_OVERFLOW0)
+{
+  TCNT0 += CTRL_TCNT0;
+  if (busy)
+    return;
+  busy = TRUE;
+  sei ();
+  if (ctrlon)
+    CtrlTick ();
+  if (motorslew)
+    MotorSlewTick ();
+  if (bghook)
+    bghook ();
+  cli ();
+  busy = FALSE;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Startet Timer 0 mit CTRL_HZ, falls er noch nicht laeuft.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Aufruf nur mit gesperrten Interrupts.
+*****************************************************************************/
+static void CtrlTimerStart (
+  void)
+{
+  if (TIMSK & (1 << TOIE0))
+    return;
+  TCCR0  = (1 << CS02);                 // MCU-Takt/256
+  TCNT0  = CTRL_TCNT0;
+  TIMSK |= (1 << TOIE0);
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Haelt Timer 0 an, wenn weder Regelung, Rampe noch CtrlBackground()\n
+  ihn brauchen.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Aufruf nur mit gesperrten Interrupts.
+*****************************************************************************/
+static void CtrlTimerStop (
+  void)
+{
+  if (ctrlon || motorslew || bghook)
+    return;
+  TIMSK &= ~(1 << TOIE0);
+  TCCR0 = 0;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Startet die Geschwindigkeitsregelung im Hintergrund.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \see
+  CtrlSpeed(), CtrlStop()
+
+  \par  Hinweis:
+  Laeuft die Odometrie noch nicht, wird EncoderInit() aufgerufen.\n
+  Solange die Regelung laeuft, gehoeren die Motoren dem Regler:\n
+  MotorSpeed() und MotorDir() aus dem eigenen Programm werden im\n
+  naechsten Takt ueberschrieben.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  CtrlInit ();
+  CtrlSpeed (150, 150);                 // 15 cm/s geradeaus
+  while (PollSwitch () == 0)
+    ;                                   // Programm laeuft weiter
+  CtrlStop ();
+  \endcode
+*****************************************************************************/
+void CtrlInit (
+  void)
+{
+  unsigned char sreg = SREG;
+
+  if (!autoencode)
+    EncoderInit ();
+
+  cli ();
+  target [LEFT]  = target [RIGHT]  = 0;
+  integ [LEFT]   = integ [RIGHT]   = 0;
+  started [LEFT] = started [RIGHT] = FALSE;
+  ctrlon = TRUE;
+  CtrlTimerStart ();
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Beendet die Geschwindigkeitsregelung und haelt die Motoren an.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Eine mit CtrlHook() eingetragene Funktion wird dabei ausgetragen.\n
+  Ist eine Rampe (MotorSlew()) eingestellt oder mit CtrlBackground()\n
+  eine Funktion eingetragen, laeuft Timer 0 fuer sie weiter.
+*****************************************************************************/
+void CtrlStop (
+  void)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  ctrlon = FALSE;
+  hook   = 0;
+  CtrlTimerStop ();
+  target [LEFT] = target [RIGHT] = 0;
+  output [LEFT] = output [RIGHT] = 0;
+  SREG = sreg;
+  MotorSpeed (0, 0);
+  MotorDir (BREAK, BREAK);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Gibt die Sollgeschwindigkeit beider Raeder vor.
+
+  \param[in]
+  left Sollwert linkes Rad in mm/s, negativ = rueckwaerts
+  \param[in]
+  right Sollwert rechtes Rad in mm/s, negativ = rueckwaerts
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Die Funktion kehrt sofort zurueck. Bei 0 wird das Rad gebremst\n
+  (BREAK) und der Integralanteil geloescht.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  CtrlSpeed (100, -100);                // auf der Stelle drehen
+  \endcode
+*****************************************************************************/
+void CtrlSpeed (
+  int left,
+  int right)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  target [LEFT]  = left;
+  target [RIGHT] = right;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Aendert die Verstaerkungen des PID-Reglers.
+
+  \param[in]
+  kp Proportionalanteil (256 = 1 PWM-Schritt je mm/s)
+  \param[in]
+  ki Integralanteil je Regeltakt
+  \param[in]
+  kd Differentialanteil je Regeltakt
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Voreinstellung aus MY_CTRL_KP, MY_CTRL_KI, MY_CTRL_KD in myasuro.h
+*****************************************************************************/
+void CtrlGains (
+  int kp,
+  int ki,
+  int kd)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  gainp = kp;
+  gaini = ki;
+  gaind = kd;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert die zuletzt ausgegebene PWM eines Rades.
+
+  \param[in]
+  side LEFT oder RIGHT
+
+  \return
+  PWM -255..255, negativ = rueckwaerts
+*****************************************************************************/
+int CtrlPwm (
+  unsigned char side)
+{
+  int           pwm;
+  unsigned char sreg = SREG;
+
+  cli ();
+  pwm = output [side];
+  SREG = sreg;
+  return pwm;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Traegt eine Funktion ein, die in jedem Regeltakt nach der Messung der\n
+  Radgeschwindigkeit und vor dem Regler aufgerufen wird.
+
+  \param[in]
+  fn Rueckruffunktion, NULL = keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Die Funktion laeuft im Interrupt SIG_OVERFLOW0 (mit freigegebenen\n
+  Interrupts) und darf CtrlSpeed() aufrufen. Sie muss deutlich kuerzer\n
+  als ein Regeltakt (8 ms) sein.
+*****************************************************************************/
+void CtrlHook (
+  void (*fn) (void))
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  hook = fn;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Prueft, ob die Geschwindigkeitsregelung laeuft.
+
+  \param
+  keine
+
+  \return
+  TRUE nach CtrlInit(), FALSE nach CtrlStop()
+*****************************************************************************/
+unsigned char CtrlActive (
+  void)
+{
+  return ctrlon;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Stellt eine Rampe fuer die Motor-PWM ein. Die Motoren folgen\n
+  MotorSpeed(), MotorSpeed16() und MotorDir() dann nur noch langsam.
+
+  \param[in]
+  ms Zeit in ms von Stillstand bis volle PWM, 0 = keine Rampe
+
+  \return
+  nichts
+
+  \see
+  MotorSlewSet(), MotorSlewTick() in motor_low.c
+
+  \par  Hinweis:
+  Die Rampe laeuft im Regeltakt von Timer 0 (CTRL_HZ), auch ohne\n
+  CtrlInit(). Bei einem Richtungswechsel wird erst auf 0 heruntergefahren\n
+  und dann umgeschaltet, das schont Getriebe und Akku (keine\n
+  Stromspitzen beim harten Umpolen). Werte unter einem Regeltakt (8 ms)\n
+  ergeben einen Sprung je Takt.\n
+  Sound() und MotorCalibrate() schalten die Rampe fuer ihre Dauer ab.\n
+  Aufwand: ein Aufruf von MotorSlewTick() je Takt, geschaetzt 200\n
+  Zyklen, bei 125 Hz also etwa 0.3 % der Rechenzeit.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  MotorSlew (250);                      // 0 -> voll in 250 ms
+  MotorDir (FWD, FWD);
+  MotorSpeed (200, 200);                // faehrt weich an
+  Msleep (1000);
+  MotorDir (RWD, RWD);                  // erst abbremsen, dann umpolen
+  \endcode
+*****************************************************************************/
+void MotorSlew (
+  unsigned int ms)
+{
+  unsigned long ticks = ((unsigned long) ms * CTRL_HZ) / 1000;
+  unsigned char sreg;
+
+  if (ticks == 0)
+    ticks = 1;
+  sreg = SREG;
+  cli ();
+  if (ms)
+  {
+    MotorSlewSet ((unsigned int) (65535UL / ticks));
+    CtrlTimerStart ();
+  }
+  else
+  {
+    MotorSlewSet (0);
+    CtrlTimerStop ();
+  }
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Traegt eine Funktion ein, die in jedem Takt von Timer 0 aufgerufen\n
+  wird, auch ohne CtrlInit().
+
+  \param[in]
+  fn Rueckruffunktion, NULL = keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Fuer Rechnungen, die zu lang fuer die Interrupts von ADC und Odometrie\n
+  sind, aber regelmaessig laufen sollen (z.B. die Positionsberechnung in\n
+  pose.c). Die Funktion laeuft wie bei CtrlHook() im Interrupt\n
+  SIG_OVERFLOW0 mit freigegebenen Interrupts, nach Regler und Rampe.\n
+  Timer 0 wird bei Bedarf gestartet und mit NULL wieder angehalten,\n
+  wenn ihn sonst niemand braucht.
+*****************************************************************************/
+void CtrlBackground (
+  void (*fn) (void))
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  bghook = fn;
+  if (fn)
+    CtrlTimerStart ();
+  else
+    CtrlTimerStop ();
+  SREG = sreg;
+}
@@ -34,6 +34,21 @@
             Im Beispiel zur Funktion die Variablendefinition in der
             for()-Schleife fuer i entfernt, da sie nicht immer uebersetzbar
             ist.
+  \version  V006 - 17.10.2026\n
+            +++ GoTurn()\n
+            Ticks ueber EncoderSnapshot()/EncoderDelta() statt encoder[] mit\n
+            EncoderSet (0, 0) zuruecksetzen. Dabei gingen Ticks verloren.
+  \version  V007 - 17.10.2026\n
+            +++ GoTurn()\n
+            Nur noch eine blockierende Huelle um MotionGo()/MotionTurn() und\n
+            MotionWait(). Der Gleichlauf kommt aus der Geschwindigkeitsregelung\n
+            in ctrl.c, das Msleep (200) am Ende entfaellt.
+  \version  V008 - 17.10.2026\n
+            +++ GoTurn()\n
+            speed mit Motorkennlinie ueber motorvmax in mm/s umrechnen
+  \version  V009 - 17.10.2026\n
+            +++ GoArc()  NEU\n
+            Kreisbogen mit Radius und Winkel, blockierend wie GoTurn()
 *****************************************************************************/
 /*****************************************************************************
 *                                                                            *
@@ -45,6 +60,37 @@
 *****************************************************************************/
 #include "asuro.h"
 #include "myasuro.h"
+#include "motion.h"
+
+#define GOTURN_VMIN   20                // kleinste Geschwindigkeit in mm/s
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Rechnet den speed-Parameter von GoTurn() und GoArc() in mm/s um.
+
+  \param[in]
+  speed Geschwindigkeit wie bei MotorSpeed() (0..255)
+
+  \return
+  Geschwindigkeit in mm/s, mindestens GOTURN_VMIN
+*****************************************************************************/
+static int GoSpeed (
+  int speed)
+{
+  int v;
+
+  /* PWM value as before -> mm/s (inverse of the feed-forward) */
+  if (motorlin)
+    v = (int) (((long) abs (speed) * motorvmax) >> 8);
+  else
+    v = (int) (((long) (abs (speed) - MY_CTRL_FF_OFFSET) * 256L) / MY_CTRL_FF_GAIN);
+  if (v < GOTURN_VMIN)
+    v = GOTURN_VMIN;
+  return v;
+}
 
 
 /***************************************************************************
@@ -52,7 +98,7 @@
 *
 *   Go's a distance in mm  OR
 *   Turn's given angle.
-* Attention: EncoderInit() has to be called first.
+* The odometry and the speed controller are started if necessary.
 *
 * the driven distance depends a little bit from the floor friction
 * limitations: maximum distance +-32m
@@ -83,8 +129,8 @@
   ODER\n
   Dreht um einen bestimmten Winkel mit einer bestimmten Geschwindigkeit.
   (Autor: stochri)\n
-  Benutzt die Odometrie Sensoren im Interrupt Betrieb.\n
-  Vor dem ersten Aufruf muss deshalb EncoderInit() aufgerufen werden.
+  Benutzt die Odometrie Sensoren im Interrupt Betrieb und die\n
+  Geschwindigkeitsregelung aus ctrl.c. Beides wird bei Bedarf gestartet.
 
   \param[in]
   distance Distanz in mm (- rueckwaerts, + = vorwaerts)\n
@@ -92,7 +138,10 @@
   \param[in]
   degree Winkel (- rechts, + links)
   \param[in]
-  speed Geschwindigkeit (Wertebereich 0...255)
+  speed Geschwindigkeit (Wertebereich 0...255)\n
+        Wird ueber MY_CTRL_FF_OFFSET und MY_CTRL_FF_GAIN in mm/s\n
+        umgerechnet, z.B. 200 -> 300 mm/s. Nach MotorCalibrate()\n
+        ist 256 die volle Geschwindigkeit motorvmax.
 
   \return
   nichts
@@ -102,8 +151,11 @@
   Programmcode nicht umschreiben zu muessen.
 
   \see
-  In der globale Variable encoder, werden die Hell-/Dunkelwechsel der\n
-  Encoderscheiben im Interruptbetrieb gezaehlt.
+  GoTurn() haengt den Abschnitt mit MotionGo() oder MotionTurn() an die\n
+  Warteschlange aus motion.c und wartet mit MotionWait(), bis er (und alle\n
+  vorher angehaengten) abgefahren ist. Wer waehrenddessen Taster, RC5 oder\n
+  die serielle Schnittstelle bedienen will, benutzt die Motion-Funktionen\n
+  direkt.
 
   \par  Hinweis:
   Die Berechnung der zu fahrenden Ticks beruht auf der Annahme, dass die\n
@@ -130,71 +182,67 @@ void GoTurn (
   int degree,
   int speed)
 {
-  unsigned  long  enc_count;
-            int   tot_count = 0;
-            int   diff = 0;
-            int   l_speed = speed, r_speed = speed;
-
-  /* stop the motors until the direction is set */
-  MotorSpeed (0, 0);
+  int v = GoSpeed (speed);
 
-  /* if distance is NOT zero, then take this value to go ... */
+  /* queue the segment and wait until the queue is empty */
   if (distance != 0)
-  {
-    /* calculate tics from mm */
-    enc_count  = abs (distance) * 10000L;
-    enc_count /= MY_GO_ENC_COUNT_VALUE;
-
-    if (distance < 0)
-      MotorDir (RWD, RWD);
-    else
-      MotorDir (FWD, FWD);
-  }
-  /* ... else take the value degree for a turn */
+    MotionGo (distance, v);
   else
-  {
-    /*  calculate tics from degree */
-    enc_count  = abs (degree) * MY_TURN_ENC_COUNT_VALUE;
-    enc_count /= 360L;
-
-    if (degree < 0)
-      MotorDir (RWD, FWD);
-    else
-      MotorDir (FWD, RWD);
-  }
+    MotionTurn (degree, v);
+  MotionWait ();
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Faehrt einen Kreisbogen mit einem bestimmten Radius um einen bestimmten\n
+  Winkel, ohne anzuhalten.
+
+  \param[in]
+  radius Radius der Fahrzeugmitte in mm (das Vorzeichen wird ignoriert)
+  \param[in]
+  degree Winkel (+ rechts, - links)
+  \param[in]
+  speed Geschwindigkeit des aeusseren Rades wie bei GoTurn() (0..255)
+
+  \return
+  nichts
 
-  /* reset encoder */
-  EncoderSet (0, 0);
+  \see
+  GoTurn(), MotionArc()
 
-  /* now start the machine */
-  MotorSpeed (l_speed, r_speed);
+  \par  Hinweis:
+  Wartet wie GoTurn(), bis die Warteschlange aus motion.c leer ist.\n
+  Boegen fahren wie bei MotionArc() immer vorwaerts, ein negativer Radius\n
+  wird wie ein positiver gefahren.\n
+  Die Raeder fahren ihre Ticks im Verhaeltnis\n
+  (R + Radabstand / 2) : (R - Radabstand / 2) ab. Der Gleichlauf in\n
+  motion.c haelt dieses Verhaeltnis ueber die gefahrenen Ticks ein, nicht\n
+  nur ueber die Geschwindigkeiten. Bei einem Radius unter dem halben\n
+  Radabstand (ca. 55 mm) dreht das innere Rad rueckwaerts.\n
+  Statt Drehung, Gerade, Drehung faehrt der Asuro so ohne Halt zum Ziel:\n
+  das spart Zeit, und die Fehler beim Anhalten und Anfahren fallen weg.
 
-  while (tot_count < enc_count)
+  \par Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Rechteck 400 x 300 mm mit abgerundeten Ecken (Radius 100 mm)
+  for (i = 0; i < 2; i++)
   {
-    tot_count += encoder [LEFT];
-    diff = encoder [LEFT] - encoder [RIGHT];
-
-    if (diff > 0)
-    { /* Left faster than right */
-      if ((l_speed > speed) || (r_speed > 244))
-        l_speed -= 10;
-      else
-        r_speed += 10;
-    }
-
-    if (diff < 0)
-    { /* Right faster than left */
-      if ((r_speed > speed) || (l_speed > 244))
-        r_speed -= 10;
-      else
-        l_speed += 10;
-    }
-    /* reset encoder */
-    EncoderSet (0, 0);
-
-    MotorSpeed (l_speed, r_speed);
-    Msleep (1);
+    GoTurn (200, 0, 150);
+    GoArc (100, 90, 150);
+    GoTurn (100, 0, 150);
+    GoArc (100, 90, 150);
   }
-  MotorDir (BREAK, BREAK);
-  Msleep (200);
+  \endcode
+*****************************************************************************/
+void GoArc (
+  int radius,
+  int degree,
+  int speed)
+{
+  MotionArc (radius, degree, GoSpeed (speed));
+  MotionWait ();
 }
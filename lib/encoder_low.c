@@ -24,6 +24,29 @@
             Die Fehlerbeschreibung von Sternthaler ersatzlos gestrichen, da\n
             die Funktionalitaet von stochri durch das Starten des AD-Wandlers\n
             in EncoderInit() im sogenannten 'free running'-Mode gegeben ist.
+  \version  V004 - 17.10.2026\n
+            +++ EncoderInit(), EncoderStart()\n
+            Die Radsensoren werden im ADC Sequencer (SIGNAL (SIG_ADC)) mit\n
+            gemessen. Der Wandler laeuft nicht mehr im 'free running'-Mode.
+  \version  V005 - 17.10.2026\n
+            +++ EncoderAutoThreshold(), EncoderQuality()  NEU\n
+            Selbstkalibrierende Schwellwerte fuer die Radsensoren.
+  \version  V006 - 17.10.2026\n
+            +++ EncoderSnapshot(), EncoderDelta()  NEU\n
+            Konsistentes Lesen der 32-Bit Zaehler enctick mit Zeitstempel.\n
+            +++ EncoderSet()\n
+            Schreiben gegen den Interrupt gesperrt.
+  \version  V007 - 17.10.2026\n
+            +++ EncoderSpeedUpdate(), EncoderSpeed(), EncoderSpeedMm()  NEU\n
+            Radgeschwindigkeit aus den Zeitstempeln der Ticks (enctime).
+  \version  V008 - 17.10.2026\n
+            +++ EncoderSpeedMm()\n
+            Runden statt abschneiden (-0.5 mm/s Versatz)
+  \version  V009 - 17.10.2026\n
+            +++ EncoderSpeedUpdate()\n
+            Wert auch dann mit der Zeit begrenzen, wenn nach der letzten\n
+            Messung schon Ticks kamen. Blieb das Rad danach stehen, hielt\n
+            sich der alte Wert bis MY_ENC_SPEED_TIMEOUT.
 *****************************************************************************/
 /*****************************************************************************
 *                                                                            *
@@ -34,6 +57,17 @@
 *                                                                            *
 *****************************************************************************/
 #include "asuro.h"
+#include "myasuro.h"
+
+/*
+  Umrechnung ms -> Takte von Timer 2 (36 kHz), Einheit von enctime
+*/
+#define ENC_T36(ms) ((unsigned int) ((ms) * 36L))
+
+static long          spdtick [2];       // enctick an der letzten Messflanke
+static unsigned int  spdtime [2];       // enctime an der letzten Messflanke
+static int           spdval [2];        // geschaetzte Geschwindigkeit Ticks/s * 16
+static unsigned char spdrun [2];        // spdtick/spdtime gueltig
 
 
 
@@ -66,7 +100,9 @@
   in der globalen Variablen encoder[] weitergezaehlt.\n
   Ausserdem wird dort dann der AD-Wandler fuer die andere Seite gestartet.\n
   Da dies dann ab nun immer Wechsel laeuft, kann das Hauptprogramm, ohne\n
-  weiters Zutun von nun ab auf die Zaehlerwerte in encoder[] zugreifen.
+  weiters Zutun von nun ab auf die Zaehlerwerte in encoder[] zugreifen.\n
+  Die Radsensoren werden dabei vom ADC Sequencer zwischen die Kanaele aus\n
+  adcscan geschoben (siehe AdcScanStart() in adc.c).
 
   \par  Beispiel:
   (Nur zur Demonstration der Parameter/Returnwerte)
@@ -111,21 +147,15 @@ void EncoderInit (void)
   ODOMETRIE_LED_ON;
 
   /*
-    AD-Wandler einschalten, Parameter einstellen und Starten. (clk/128)
-    Startet den ADC im 'free running'-Mode (ADFR). Das heisst, der Wandler
-    nach einer Messung automatisch wieder ne startet.
-  */
-  ADCSRA = (1<<ADEN) | (1<<ADFR) | (1<<ADIE) | (1<<ADSC) | (1<<ADPS0) | (1<<ADPS1) | (1<<ADPS2);
-
-  /*
-    Linken Odometrie-Sensor auswaehlen. (AVCC ref. with external capacitor)
+    Odometrie im Interruptbetrieb weiter bearbeiten.
   */
-  ADMUX = (1<<ADLAR) | (1<<REFS0) | WHEEL_LEFT;
+  autoencode = TRUE;
 
   /*
-    Odometrie im Interruptbetrieb weiter bearbeiten.
+    ADC Sequencer (neu) starten. Die erste Messung ist der linke
+    Odometrie-Sensor, danach wird im Interrupt reihum weiter gemessen.
   */
-  autoencode = TRUE;
+  AdcScanStart ();
 
   /*
     Alle definierten Interrupts im Asuro wieder zulassen.
@@ -156,9 +186,9 @@ void EncoderInit (void)
 
   \par  Funktionsweise:
   Durch das setzen der globalen Variablen autoencode auf FALSE wird in\n
-  der AD-Wandler-Interruptfunktion der Teil zur Bearbeitung uebersprungen.\n
-  Dadurch wird der Wandler nicht mehr neu gestartet und somit stopp die\n
-  Automatik.
+  der AD-Wandler-Interruptfunktion das Messen der Radsensoren uebersprungen\n
+  und die Zaehler in encoder[] bleiben stehen. Die uebrigen Kanaele aus\n
+  adcscan werden vom Sequencer weiter gemessen.
 
   \par  Beispiel:
   (siehe unter EncoderInit bzw. in den examples)
@@ -190,6 +220,8 @@ void EncoderStop (void)
 void EncoderStart (void)
 {
   autoencode = TRUE;
+  if (!adcscanon)
+    AdcScanStart ();                    // Sequencer lief nicht mehr
 }
 
 
@@ -223,6 +255,351 @@ void EncoderSet (
   int setl,
   int setr)
 {
+  unsigned char sreg = SREG;
+
+  cli ();                               // 16-Bit-Zugriff nicht atomar
   encoder [LEFT]  = setl;
   encoder [RIGHT] = setr;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Schaltet die selbstkalibrierenden Schwellwerte der Odometrie ein oder aus.
+
+  \param[in]
+  status ON: Schwellwerte aus dem Kontrast der Encoderscheibe,\n
+         OFF: feste Werte MY_ODO_xxx aus myasuro.h
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Der Interrupt SIG_ADC verfolgt je Rad den hellsten und dunkelsten Wert\n
+  (Huellkurven odomax und odomin). Neue Extremwerte werden sofort\n
+  uebernommen, sonst laufen die Kurven mit MY_ODO_ENV_DECAY langsam auf\n
+  den Messwert zu. So passen sich die Schwellen an die Scheibe, die\n
+  Sensoren und das Umgebungslicht an. Ist der Kontrast kleiner als\n
+  MY_ODO_MIN_CONTRAST (z.B. stehendes Rad), wird nicht gezaehlt.\n
+  Beim Einschalten beginnen die Kurven neu. Die ersten Wechsel der\n
+  Encoderscheibe werden zum Einlernen gebraucht.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  EncoderInit ();
+  EncoderAutoThreshold (ON);
+  \endcode
+*****************************************************************************/
+void EncoderAutoThreshold (
+  unsigned char status)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  odomin [LEFT]  = odomin [RIGHT] = 1023 << 4;
+  odomax [LEFT]  = odomax [RIGHT] = 0;
+  odoauto = status;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert ein Mass fuer die Signalqualitaet eines Radsensors.
+
+  \param[in]
+  side LEFT oder RIGHT
+
+  \return
+  Kontrast zwischen Hell- und Dunkel-Huellkurve in 10-Bit-ADC-Schritten.\n
+  Unter MY_ODO_MIN_CONTRAST wird nicht gezaehlt. Nur gueltig, solange\n
+  EncoderAutoThreshold() eingeschaltet ist, sonst 0.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  if (EncoderQuality (LEFT) < 100)
+    StatusLED (YELLOW);                 // schwaches Signal
+  \endcode
+*****************************************************************************/
+unsigned int EncoderQuality (
+  unsigned char side)
+{
+  unsigned int  lo, hi;
+  unsigned char sreg = SREG;
+
+  cli ();
+  lo = odomin [side];
+  hi = odomax [side];
+  SREG = sreg;
+  if (!odoauto || hi <= lo)
+    return 0;
+  return (hi - lo) >> 4;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liest beide 32-Bit Odometrie Zaehler und die Zeit in einem Zug.
+
+  \param[out]
+  snap Zaehlerstaende snap->tick[LEFT], snap->tick[RIGHT] und die Zeit\n
+       snap->time in ms (wie Gettime())
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Die Zaehler werden mit gesperrten Interrupts kopiert und koennen deshalb\n
+  nicht halb alt und halb neu sein. Die Umrechnung der Zeit in ms erfolgt\n
+  erst danach, damit die Interrupts nur wenige Takte gesperrt sind.\n
+  Die Zaehler werden nie zurueckgesetzt. Differenzen liefert EncoderDelta().
+
+  \par  Beispiel:
+  (siehe unter EncoderDelta)
+*****************************************************************************/
+void EncoderSnapshot (
+  encoder_snapshot_t *snap)
+{
+  unsigned long tb;
+  unsigned char cnt;
+  unsigned char sreg = SREG;
+
+  cli ();
+  snap->tick [LEFT]  = enctick [LEFT];
+  snap->tick [RIGHT] = enctick [RIGHT];
+  tb  = timebase;
+  cnt = count36kHz;
+  SREG = sreg;
+  snap->time = ((tb * 256) + cnt) / 36;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert die Ticks seit dem letzten Snapshot, ohne die Zaehler\n
+  zurueckzusetzen. Der Snapshot wird dabei auf den aktuellen Stand gesetzt.
+
+  \param[in,out]
+  snap letzter Snapshot (von EncoderSnapshot() oder EncoderDelta())
+  \param[out]
+  delta delta[LEFT], delta[RIGHT]: Ticks mit Vorzeichen (vorwaerts positiv)
+
+  \return
+  Vergangene Zeit in ms (maximal 65535)
+
+  \par  Hinweis:
+  Anders als mit EncoderSet(0, 0) geht dabei kein Tick verloren, der\n
+  zwischen Lesen und Zuruecksetzen gezaehlt wird.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  encoder_snapshot_t snap;
+  long delta [2];
+
+  EncoderInit ();
+  EncoderSnapshot (&snap);
+  while (1)
+  {
+    Msleep (100);
+    EncoderDelta (&snap, delta);
+    PrintLong (delta [LEFT] - delta [RIGHT]); // Gleichlauf
+  }
+  \endcode
+*****************************************************************************/
+unsigned int EncoderDelta (
+  encoder_snapshot_t *snap,
+  long *delta)
+{
+  encoder_snapshot_t now;
+  unsigned long dt;
+
+  EncoderSnapshot (&now);
+  delta [LEFT]  = now.tick [LEFT]  - snap->tick [LEFT];
+  delta [RIGHT] = now.tick [RIGHT] - snap->tick [RIGHT];
+  dt = now.time - snap->time;
+  *snap = now;
+  return (dt > 0xFFFF) ? 0xFFFF : (unsigned int) dt;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Berechnet die Geschwindigkeit beider Raeder aus den Zeitstempeln der\n
+  Odometrie-Ticks neu.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \see
+  enctick, enctime (gesetzt im Interrupt SIGNAL (SIG_ADC) in asuro.c)\n
+  MY_ENC_SPEED_WINDOW, MY_ENC_SPEED_TIMEOUT in myasuro.h
+
+  \par  Funktionsweise:
+  Gemessen wird immer von Flanke zu Flanke (M/T-Verfahren): Anzahl Ticks\n
+  geteilt durch die Zeit zwischen der ersten und der letzten Flanke,\n
+  sobald diese Zeit mindestens MY_ENC_SPEED_WINDOW ms betraegt.\n
+  Bei langsamen Raedern ist das die Periode eines einzelnen Ticks, bei\n
+  schnellen werden alle Ticks im Fenster gezaehlt. Die Zeitstempel haben\n
+  die Aufloesung des ADC Sequencers (ca. 0.4 ms je Rad), anders als beim\n
+  Zaehlen in einem festen Zeitraster fallen angebrochene Ticks weg.\n
+  Ist das Fenster noch nicht voll, kann das Rad seit der letzten\n
+  Messflanke hoechstens einen Tick mehr als gezaehlt gemacht haben: die\n
+  Geschwindigkeit wird auf diesen Wert begrenzt und faellt nach\n
+  MY_ENC_SPEED_TIMEOUT ms auf 0.
+
+  \par  Hinweis:
+  Muss regelmaessig (alle paar ms) aufgerufen werden, wenn die Werte aus\n
+  EncoderSpeed() gebraucht werden. Die Drehrichtung kommt aus enctick und\n
+  damit aus MotorDir(). Zwischen zwei Aufrufen duerfen hoechstens 1.8 s\n
+  liegen (Ueberlauf von enctime).
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  EncoderInit ();
+  MotorSpeed (150, 150);
+  while (1)
+  {
+    Msleep (10);
+    EncoderSpeedUpdate ();
+    PrintInt (EncoderSpeedMm (LEFT));   // z.B. 180
+  }
+  \endcode
+*****************************************************************************/
+void EncoderSpeedUpdate (
+  void)
+{
+  unsigned char side, sreg;
+  unsigned int  t, now, dt, idle;
+  long          tick, dn, v;
+
+  for (side = LEFT; side <= RIGHT; side++)
+  {
+    sreg = SREG;
+    cli ();
+    tick = enctick [side];
+    t    = enctime [side];
+    now  = ((unsigned int) timebase << 8) | count36kHz;
+    SREG = sreg;
+
+    dn = tick - spdtick [side];
+    if (!spdrun [side])
+    {
+      /*
+        Erste Flanke nach dem Stillstand ist nur der Startpunkt
+      */
+      if (dn && (unsigned int) (now - t) < ENC_T36 (MY_ENC_SPEED_TIMEOUT))
+      {
+        spdtick [side] = tick;
+        spdtime [side] = t;
+        spdrun [side]  = TRUE;
+      }
+      continue;
+    }
+
+    dt   = t - spdtime [side];
+    idle = now - spdtime [side];
+    if (idle > ENC_T36 (MY_ENC_SPEED_TIMEOUT))
+    {
+      v = 0;                            // Stillstand
+      spdrun [side]  = FALSE;
+    }
+    else if (dn && dt >= ENC_T36 (MY_ENC_SPEED_WINDOW))
+    {
+      v = (dn * (36000L * 16) + (dt >> 1)) / dt;
+      spdtick [side] = tick;
+      spdtime [side] = t;
+    }
+    else
+    {
+      v = spdval [side];
+      dn = labs (dn) + 1;               // seit spdtime weniger als dn Ticks
+      if (labs (v) * idle > dn * (36000L * 16))
+        v = (v > 0) ? (dn * (36000L * 16)) / idle : -((dn * (36000L * 16)) / idle);
+    }
+    sreg = SREG;
+    cli ();
+    spdval [side] = v;
+    SREG = sreg;
+  }
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert die zuletzt mit EncoderSpeedUpdate() berechnete Geschwindigkeit.
+
+  \param[in]
+  side LEFT oder RIGHT
+
+  \return
+  Geschwindigkeit in Ticks/s (vorwaerts positiv)
+
+  \par  Beispiel:
+  (siehe unter EncoderSpeedUpdate)
+*****************************************************************************/
+int EncoderSpeed (
+  unsigned char side)
+{
+  int           v;
+  unsigned char sreg = SREG;
+
+  cli ();
+  v = spdval [side];
+  SREG = sreg;
+  return (v + 8) >> 4;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert die zuletzt mit EncoderSpeedUpdate() berechnete Geschwindigkeit\n
+  in mm/s.
+
+  \param[in]
+  side LEFT oder RIGHT
+
+  \return
+  Geschwindigkeit in mm/s (vorwaerts positiv)
+
+  \par  Hinweis:
+  Umrechnung mit MY_GO_ENC_COUNT_VALUE aus myasuro.h (1.9363 mm/Tick)\n
+  aus dem intern 16-fach aufgeloesten Wert.
+
+  \par  Beispiel:
+  (siehe unter EncoderSpeedUpdate)
+*****************************************************************************/
+int EncoderSpeedMm (
+  unsigned char side)
+{
+  long          v;
+  unsigned char sreg = SREG;
+
+  cli ();
+  v = spdval [side];
+  SREG = sreg;
+  v *= MY_GO_ENC_COUNT_VALUE;
+  v += (v < 0) ? -(10000L * 8) : (10000L * 8); // runden wie EncoderSpeed()
+  return (int) (v / (10000L * 16));
 }
@@ -0,0 +1,472 @@
+/****************************************************************************/
+/*!
+  \file     fixmath.c
+
+  \brief    Festkomma-Arithmetik ohne float.\n
+            Multiplikation und Division in Q8.8 und Q16.16, ganzzahlige\n
+            Wurzel, Sinus/Cosinus und Arcustangens aus Tabellen im Flash.
+
+  \see      fix8_t, fix16_t, FIX8, FIX16, FIX_ANGLE in fixmath.h
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            +++ Fix16Mul()\n
+            Untere 16-Bit-Haelften maskieren (PC Test mit 32-Bit int)
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include <avr/pgmspace.h>
+#include "asuro.h"
+#include "fixmath.h"
+
+#define FIX_PI      3.14159265358979323846
+#define FIX16_MAX   0x7FFFFFFFL
+
+/*
+  Tabellen fuer Sinus und Arcustangens.
+  Die Eintraege rechnet der Compiler mit __builtin_sin() und
+  __builtin_atan() beim Uebersetzen aus, im Programm landen nur die fertigen
+  Zahlen im Flash. Es wird keine float-Bibliothek dazugelinkt.
+
+  sintab [i]  = sin (i * 90 / 64 Grad) * 32767            i = 0..64
+  atantab [i] = atan (i / 64) * 65536 / 360 Grad          i = 0..64
+*/
+#define FIX_SIN(i) \
+  ((int) (__builtin_sin ((i) * (FIX_PI / 128.0)) * 32767.0 + 0.5))
+#define FIX_SIN4(i) \
+  FIX_SIN (i), FIX_SIN (i + 1), FIX_SIN (i + 2), FIX_SIN (i + 3)
+#define FIX_ATAN(i) \
+  ((unsigned int) (__builtin_atan ((i) / 64.0) * (32768.0 / FIX_PI) + 0.5))
+#define FIX_ATAN4(i) \
+  FIX_ATAN (i), FIX_ATAN (i + 1), FIX_ATAN (i + 2), FIX_ATAN (i + 3)
+
+static const int sintab [65] PROGMEM =
+{
+  FIX_SIN4 (0),  FIX_SIN4 (4),  FIX_SIN4 (8),  FIX_SIN4 (12),
+  FIX_SIN4 (16), FIX_SIN4 (20), FIX_SIN4 (24), FIX_SIN4 (28),
+  FIX_SIN4 (32), FIX_SIN4 (36), FIX_SIN4 (40), FIX_SIN4 (44),
+  FIX_SIN4 (48), FIX_SIN4 (52), FIX_SIN4 (56), FIX_SIN4 (60),
+  FIX_SIN (64)
+};
+
+static const unsigned int atantab [65] PROGMEM =
+{
+  FIX_ATAN4 (0),  FIX_ATAN4 (4),  FIX_ATAN4 (8),  FIX_ATAN4 (12),
+  FIX_ATAN4 (16), FIX_ATAN4 (20), FIX_ATAN4 (24), FIX_ATAN4 (28),
+  FIX_ATAN4 (32), FIX_ATAN4 (36), FIX_ATAN4 (40), FIX_ATAN4 (44),
+  FIX_ATAN4 (48), FIX_ATAN4 (52), FIX_ATAN4 (56), FIX_ATAN4 (60),
+  FIX_ATAN (64)
+};
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Multipliziert zwei Q8.8-Werte.
+
+  \param[in]
+  a, b Faktoren
+
+  \return
+  a * b gerundet, bei Ueberlauf -32767 oder 32767
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  fix8_t r = Fix8Mul (FIX8 (1.5), FIX8 (-2.25));   // FIX8 (-3.375)
+  \endcode
+*****************************************************************************/
+fix8_t Fix8Mul (
+  fix8_t a,
+  fix8_t b)
+{
+  long p = ((long) a * b + 0x80) >> 8;
+
+  if (p > 32767)
+    return 32767;
+  if (p < -32767)
+    return -32767;
+  return (fix8_t) p;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Dividiert zwei Q8.8-Werte.
+
+  \param[in]
+  a Dividend
+  \param[in]
+  b Divisor
+
+  \return
+  a / b gerundet, bei Ueberlauf oder b = 0 -32767 oder 32767
+*****************************************************************************/
+fix8_t Fix8Div (
+  fix8_t a,
+  fix8_t b)
+{
+  unsigned long ua, ub, q;
+  unsigned char neg = FALSE;
+
+  if (a < 0)
+  {
+    ua  = -(long) a;
+    neg = TRUE;
+  }
+  else
+    ua = a;
+  if (b < 0)
+  {
+    ub  = -(long) b;
+    neg = !neg;
+  }
+  else
+    ub = b;
+
+  if (ub == 0)
+    q = 32767;
+  else
+  {
+    q = ((ua << 8) + (ub >> 1)) / ub;
+    if (q > 32767)
+      q = 32767;
+  }
+  return neg ? -(fix8_t) q : (fix8_t) q;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Multipliziert zwei Q16.16-Werte.
+
+  \param[in]
+  a, b Faktoren
+
+  \return
+  a * b gerundet, bei Ueberlauf -0x7FFFFFFF oder 0x7FFFFFFF
+
+  \par  Funktionsweise:
+  Das Produkt haette 64 Bit. Statt mit long long zu rechnen, werden die\n
+  Betraege in 16-Bit-Haelften zerlegt und vier 16x16-Bit-Produkte\n
+  addiert. Das passt zum Hardware-Multiplizierer des ATmega8.
+*****************************************************************************/
+fix16_t Fix16Mul (
+  fix16_t a,
+  fix16_t b)
+{
+  unsigned long ua, ub, r, t;
+  unsigned int  ah, al, bh, bl;
+  unsigned char ovf, neg = FALSE;
+
+  if (a < 0)
+  {
+    ua  = -(unsigned long) a;
+    neg = TRUE;
+  }
+  else
+    ua = a;
+  if (b < 0)
+  {
+    ub  = -(unsigned long) b;
+    neg = !neg;
+  }
+  else
+    ub = b;
+
+  ah = ua >> 16;
+  al = ua & 0xFFFF;                     // auch wo int mehr als 16 Bit hat
+  bh = ub >> 16;
+  bl = ub & 0xFFFF;
+
+  r = ((unsigned long) al * bl + 0x8000UL) >> 16;
+  t = (unsigned long) ah * bl;
+  r += t;
+  ovf = (r < t);
+  t = (unsigned long) al * bh;
+  r += t;
+  ovf |= (r < t);
+  t = (unsigned long) ah * bh;
+  ovf |= (t > 0x7FFF);
+  t <<= 16;
+  r += t;
+  ovf |= (r < t);
+
+  if (ovf || r > FIX16_MAX)
+    return neg ? -FIX16_MAX : FIX16_MAX;
+  return neg ? -(fix16_t) r : (fix16_t) r;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Dividiert zwei Q16.16-Werte.
+
+  \param[in]
+  a Dividend
+  \param[in]
+  b Divisor
+
+  \return
+  a / b gerundet, bei Ueberlauf oder b = 0 -0x7FFFFFFF oder 0x7FFFFFFF
+
+  \par  Funktionsweise:
+  Erst der ganzzahlige Teil mit einer 32-Bit-Division, dann die 16 Bit\n
+  hinter dem Komma (und ein Bit zum Runden) durch schrittweises\n
+  Verdoppeln des Restes. So bleibt alles in 32 Bit.
+*****************************************************************************/
+fix16_t Fix16Div (
+  fix16_t a,
+  fix16_t b)
+{
+  unsigned long ua, ub, q, r;
+  unsigned char i, neg = FALSE;
+
+  if (a < 0)
+  {
+    ua  = -(unsigned long) a;
+    neg = TRUE;
+  }
+  else
+    ua = a;
+  if (b < 0)
+  {
+    ub  = -(unsigned long) b;
+    neg = !neg;
+  }
+  else
+    ub = b;
+
+  if (ub == 0)
+    return neg ? -FIX16_MAX : FIX16_MAX;
+  q = ua / ub;
+  if (q > 0x7FFF)
+    return neg ? -FIX16_MAX : FIX16_MAX;
+  r = ua - q * ub;
+
+  for (i = 0; i < 17; i++)
+  {
+    q <<= 1;
+    if (r >= ub - r)                    // 2 * r >= ub ohne Ueberlauf
+    {
+      r -= ub - r;
+      q |= 1;
+    }
+    else
+      r <<= 1;
+  }
+  q = (q + 1) >> 1;                     // letztes Bit rundet
+  if (q > FIX16_MAX)
+    q = FIX16_MAX;
+  return neg ? -(fix16_t) q : (fix16_t) q;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Ganzzahlige Quadratwurzel.
+
+  \param[in]
+  x Radikand
+
+  \return
+  sqrt (x), abgerundet
+
+  \par  Funktionsweise:
+  Bitweise Berechnung ohne Multiplikation und Division, 16 Schritte.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Abstand zum Startpunkt in mm
+  pose_t p;
+
+  GetPose (&p);
+  PrintInt (ISqrt ((long) p.x * p.x + (long) p.y * p.y));
+  \endcode
+*****************************************************************************/
+unsigned int ISqrt (
+  unsigned long x)
+{
+  unsigned long res = 0;
+  unsigned long bit = 1UL << 30;
+
+  while (bit > x)
+    bit >>= 2;
+  while (bit)
+  {
+    if (x >= res + bit)
+    {
+      x  -= res + bit;
+      res = (res >> 1) + bit;
+    }
+    else
+      res >>= 1;
+    bit >>= 2;
+  }
+  return (unsigned int) res;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Quadratwurzel eines Q8.8-Wertes.
+
+  \param[in]
+  a Radikand
+
+  \return
+  sqrt (a), abgerundet, 0 fuer a <= 0
+*****************************************************************************/
+fix8_t Fix8Sqrt (
+  fix8_t a)
+{
+  if (a <= 0)
+    return 0;
+  return (fix8_t) ISqrt ((unsigned long) a << 8);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Sinus aus der Tabelle mit linearer Interpolation.
+
+  \param[in]
+  angle Winkel, 65536 = 360 Grad
+
+  \return
+  sin (angle) * 32767
+
+  \par  Hinweis:
+  Die Tabelle haelt nur den ersten Quadranten, die anderen werden\n
+  gespiegelt. Zwischen zwei Eintraegen (1.4 Grad) wird linear\n
+  interpoliert, der Fehler bleibt unter 4 / 32767.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  int s = FixSin (FIX_ANGLE (30));      // 16384
+  \endcode
+*****************************************************************************/
+int FixSin (
+  unsigned int angle)
+{
+  unsigned int  r = angle & 0x3FFF;
+  unsigned char i;
+  int           s, t;
+
+  if (angle & 0x4000)
+    r = 0x4000 - r;                     // 2. und 4. Quadrant gespiegelt
+  i = r >> 8;
+  s = pgm_read_word (&sintab [i]);
+  if (i < 64)
+  {
+    t = pgm_read_word (&sintab [i + 1]);
+    s += (int) (((long) (t - s) * (r & 0xFF) + 0x80) >> 8);
+  }
+  return (angle & 0x8000) ? -s : s;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Cosinus, siehe FixSin().
+
+  \param[in]
+  angle Winkel, 65536 = 360 Grad
+
+  \return
+  cos (angle) * 32767
+*****************************************************************************/
+int FixCos (
+  unsigned int angle)
+{
+  return FixSin (angle + 0x4000);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Winkel des Vektors (x, y).
+
+  \param[in]
+  y Y-Anteil
+  \param[in]
+  x X-Anteil
+
+  \return
+  Winkel von der x-Achse links herum, 65536 = 360 Grad. 0 fuer (0, 0).
+
+  \par  Funktionsweise:
+  Der kleinere durch den groesseren Betrag ergibt einen Wert 0..1 mit\n
+  14 Bit, der Arcustangens dazu kommt aus der Tabelle (interpoliert).\n
+  Der Oktant wird ueber Vorzeichen und Vertauschung zurueckgerechnet.\n
+  Eine Division je Aufruf, Fehler unter 0.01 Grad.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Richtung vom Roboter zum Ziel (500, 200) in Grad
+  pose_t p;
+
+  GetPose (&p);
+  PrintInt (POSE_DEG (FixAtan2 (200 - p.y, 500 - p.x)));
+  \endcode
+*****************************************************************************/
+unsigned int FixAtan2 (
+  int y,
+  int x)
+{
+  unsigned int  ax, ay, r, a, t;
+  unsigned char i;
+
+  ax = (x < 0) ? -(unsigned int) x : (unsigned int) x;
+  ay = (y < 0) ? -(unsigned int) y : (unsigned int) y;
+  if (ax == 0 && ay == 0)
+    return 0;
+
+  if (ay <= ax)
+    r = (unsigned int) (((unsigned long) ay << 14) / ax);
+  else
+    r = (unsigned int) (((unsigned long) ax << 14) / ay);
+
+  i = r >> 8;
+  a = pgm_read_word (&atantab [i]);
+  if (i < 64)
+  {
+    t = pgm_read_word (&atantab [i + 1]);
+    a += ((t - a) * (r & 0xFF) + 0x80) >> 8;
+  }
+
+  if (ay > ax)
+    a = 0x4000 - a;                     // Oktant ueber 45 Grad
+  if (x < 0)
+    a = 0x8000 - a;
+  if (y < 0)
+    a = -a;
+  return a;
+}
@@ -21,6 +21,39 @@
   \version  V004 - 15.11.2007 - m.a.r.v.i.n\n
             Variable switched als volatile definiert, da sie im Interrupt
             SIGNAL (SIG_INTERRUPT1) benutzt wird.
+  \version  V005 - 17.10.2026\n
+            Variablen fuer den ADC Sequencer: adcvalue, adcseq, adcvalid,
+            adcscan, adcscanlen, adcscanon
+  \version  V006 - 17.10.2026\n
+            Variablen fuer das Oversampling: adcosr, adcext, adcacc, adccnt
+  \version  V007 - 17.10.2026\n
+            Variablen fuer die Fremdlichtkompensation: linecomp, linediff,
+            lineseq
+  \version  V008 - 17.10.2026\n
+            Rueckruffunktionen adchook fuer den ADC Sequencer, pwmlimit
+  \version  V009 - 17.10.2026\n
+            Variablen fuer die selbstkalibrierende Odometrie: odoauto,
+            odomin, odomax
+  \version  V010 - 17.10.2026\n
+            Vorzeichenbehaftete 32-Bit Odometrie Zaehler enctick
+  \version  V011 - 17.10.2026\n
+            Zeitstempel der Odometrie-Ticks enctime
+  \version  V012 - 17.10.2026\n
+            Rueckruffunktion enchook fuer jeden Odometrie-Tick
+  \version  V013 - 17.10.2026\n
+            Kennlinie der Motoren: motorlin, motorlintab, motorvmax,
+            motorffgain
+  \version  V014 - 17.10.2026\n
+            TOP-Wert der Motor-PWM motorpwmtop
+  \version  V015 - 17.10.2026\n
+            Schrittweite der Motor-Rampe motorslew
+  \version  V016 - 17.10.2026\n
+            Ausgleich der Batteriespannung motorvgain
+  \version  V017 - 17.10.2026\n
+            motorvgain ersetzt durch motorvnom und motorvmv, der Faktor\n
+            wird ausserhalb vom Interrupt gerechnet
+  \version  V018 - 17.10.2026\n
+            Einzelmessung im ADC Sequencer adconeshot
 *****************************************************************************/
 /*****************************************************************************
 *                                                                            *
@@ -30,6 +63,7 @@
 *   any later version.                                                       *
 *                                                                            *
 *****************************************************************************/
+#include "asuro.h"
 
 
 
@@ -99,3 +133,359 @@ volatile unsigned long timebase;
   EncoderInit(), EncoderStart(), EncoderStop() in encoder.c
 *****************************************************************************/
 volatile int autoencode;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Letzter Messwert jedes ADC-Kanals (10 Bit), Index = ADC-Kanal.\n
+  Wird vom ADC Sequencer im Interrupt SIG_ADC geschrieben.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  AdcValue(), AdcScanStart() in adc.c
+*****************************************************************************/
+volatile unsigned int adcvalue [ADC_CHANNELS];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Zaehler je ADC-Kanal, der bei jedem neuen Wert in adcvalue[] um 1\n
+  hochgezaehlt wird. Damit kann das Hauptprogramm pruefen, ob ein Wert neu ist.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c
+*****************************************************************************/
+volatile unsigned char adcseq [ADC_CHANNELS];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Bit n ist gesetzt, wenn adcvalue[n] seit dem letzten AdcScanStart()\n
+  gemessen wurde.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  AdcScanStart() in adc.c
+*****************************************************************************/
+volatile unsigned char adcvalid;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Kanalliste des ADC Sequencers. Die Radsensoren werden bei laufender\n
+  Odometrie (autoencode) immer zwischen zwei Eintraege geschoben.\n
+  Voreinstellung: Liniensensoren, Batterie, Taster.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  AdcScanList() in adc.c
+*****************************************************************************/
+volatile unsigned char adcscan [ADC_SCAN_MAX] = {IR_LEFT, IR_RIGHT, BATTERIE, SWITCH};
+volatile unsigned char adcscanlen = 4;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  ADMUX Wert (Kanal und Referenz) fuer eine Einzelmessung. Der ADC\n
+  Sequencer misst den Kanal einmal statt des naechsten Eintrags aus\n
+  adcscan und setzt den Wert danach auf ADC_ONESHOT_NONE zurueck.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  AdcRead() in adc.c
+*****************************************************************************/
+volatile unsigned char adconeshot = ADC_ONESHOT_NONE;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  TRUE, solange der ADC Sequencer laeuft.
+
+  \see
+  AdcScanStart(), AdcScanStop() in adc.c
+*****************************************************************************/
+volatile unsigned char adcscanon;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Oversampling je ADC-Kanal: Es werden 4^adcosr[n] Messungen aufsummiert\n
+  (0 = aus, maximal 3 = 64 Messungen).
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  AdcOversample() in adc.c
+*****************************************************************************/
+volatile unsigned char adcosr [ADC_CHANNELS];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Messwert je ADC-Kanal mit erhoehter Aufloesung (10 + adcosr[n] Bit).\n
+  Ohne Oversampling identisch mit adcvalue[n].
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  AdcValueExt() in adc.c
+*****************************************************************************/
+volatile unsigned int adcext [ADC_CHANNELS];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Summe und Anzahl der bisher aufsummierten Messungen je ADC-Kanal fuer\n
+  das Oversampling. Nur fuer den Interrupt SIG_ADC.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c
+*****************************************************************************/
+volatile unsigned int  adcacc [ADC_CHANNELS];
+volatile unsigned char adccnt [ADC_CHANNELS];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  TRUE: Der ADC Sequencer misst die Liniensensoren abwechselnd mit und\n
+  ohne FrontLED (Fremdlichtkompensation).
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  LineCompensation() in adc.c
+*****************************************************************************/
+volatile unsigned char linecomp;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Differenz hell - dunkel der Liniensensoren aus einem Messpaar.\n
+  linediff[LEFT], linediff[RIGHT]. lineseq wird je neuem Paar hochgezaehlt.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  LineDataComp() in adc.c
+*****************************************************************************/
+volatile int linediff [2];
+volatile unsigned char lineseq [2];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Rueckruffunktion je ADC-Kanal. Wird vom ADC Sequencer mit jedem neuen\n
+  Wert in adcvalue[n] aufgerufen (im Interrupt!). NULL = keine.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  AdcHook() in adc.c
+*****************************************************************************/
+void (* volatile adchook [ADC_CHANNELS]) (unsigned int);
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Obergrenze fuer die PWM-Werte der Motoren. MotorSpeed() begrenzt auf\n
+  diesen Wert. Voreinstellung 255 = keine Begrenzung.
+
+  \see
+  MotorSpeed() in motor_low.c\n
+  BatteryCutoffPwm() in battery.c
+*****************************************************************************/
+volatile unsigned char pwmlimit = 255;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  TRUE: MotorSpeed() rechnet die Vorgabe ueber die Kennlinie motorlintab\n
+  in PWM um. Wird von MotorCalibrate() und MotorLinSet() gesetzt.
+
+  \see
+  MotorSpeed() in motor_low.c\n
+  MotorCalibrate(), MotorLinSet() in motor.c
+*****************************************************************************/
+volatile unsigned char motorlin;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Kennlinie je Motor: PWM fuer die Vorgabe 0, 16, 32 .. 256. Eintrag 0 ist\n
+  die Anlauf-PWM aus dem Stand (Totzone und Haftreibung), die Vorgabe 0\n
+  selbst ergibt immer PWM 0.\n
+  Beide Motoren fahren mit derselben Vorgabe gleich schnell, die Vorgabe\n
+  256 entspricht motorvmax.
+
+  \see
+  MotorSpeed() in motor_low.c\n
+  MotorCalibrate() in motor.c
+*****************************************************************************/
+unsigned char motorlintab [2][MOTOR_LIN_POINTS];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Geschwindigkeit in mm/s bei der Vorgabe 256 (schwaecherer Motor mit\n
+  voller PWM) und der Kehrwert davon fuer die Vorsteuerung\n
+  (motorffgain = 65536 / motorvmax).
+
+  \see
+  CtrlTick() in ctrl.c, GoTurn() in encoder.c
+*****************************************************************************/
+unsigned int motorvmax;
+unsigned int motorffgain;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Groesster Wert fuer OCR1A/OCR1B in der mit MotorPwmMode() eingestellten\n
+  PWM (255 nach Init(), 511, 1023 oder 399).
+
+  \see
+  MotorPwmMode(), MotorPwmOcr() in motor_low.c
+*****************************************************************************/
+volatile unsigned int motorpwmtop = 255;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Schrittweite der Motor-Rampe je Regeltakt in 16-Bit-Einheiten\n
+  (65535 = volle PWM). 0 = keine Rampe, MotorSpeed() wirkt sofort.
+
+  \see
+  MotorSlew() in ctrl.c, MotorSlewSet(), MotorSlewTick() in motor_low.c
+*****************************************************************************/
+volatile unsigned int motorslew;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Nennspannung in mV fuer den Ausgleich der Batteriespannung in\n
+  MotorSpeed(). 0 = kein Ausgleich.
+
+  \see
+  BatteryCompensate() in battery.c, MotorSpeed() in motor_low.c
+*****************************************************************************/
+volatile unsigned int motorvnom;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Gefilterte Batteriespannung in mV fuer den Ausgleich in MotorSpeed().\n
+  Wird von der Batterieueberwachung im Interrupt SIG_ADC geschrieben,\n
+  0 = noch kein Messwert.
+
+  \see
+  BatteryMonitor() in battery.c, MotorSpeed() in motor_low.c
+*****************************************************************************/
+volatile unsigned int motorvmv;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  TRUE: Die Schwellwerte der Odometrie werden aus den Huellkurven odomin\n
+  und odomax berechnet statt aus MY_ODO_xxx in myasuro.h.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  EncoderAutoThreshold() in encoder_low.c
+*****************************************************************************/
+volatile unsigned char odoauto;
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Dunkel- und Hell-Huellkurve der Radsensoren (10-Bit-ADC-Wert * 16).\n
+  odomin[LEFT], odomax[LEFT], odomin[RIGHT], odomax[RIGHT].
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  EncoderQuality() in encoder_low.c
+*****************************************************************************/
+volatile unsigned int odomin [2];
+volatile unsigned int odomax [2];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Vorzeichenbehaftete 32-Bit Odometrie Zaehler. Vorwaerts wird hoch-,\n
+  rueckwaerts heruntergezaehlt (Richtung aus MotorDir()).\n
+  enctick[LEFT], enctick[RIGHT]. Wird nie zurueckgesetzt.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  EncoderSnapshot(), EncoderDelta() in encoder_low.c
+*****************************************************************************/
+volatile long enctick [2];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Zeitpunkt des letzten Odometrie-Ticks in 1/36 ms (36 kHz-Takt von\n
+  Timer 2, untere 16 Bit von timebase * 256 + count36kHz).\n
+  enctime[LEFT], enctime[RIGHT]. Laeuft nach ca. 1.8 s ueber.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  EncoderSpeedUpdate() in encoder_low.c
+*****************************************************************************/
+volatile unsigned int enctime [2];
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Rueckruffunktion fuer jeden Odometrie-Tick mit der Seite (LEFT, RIGHT)\n
+  und der Richtung (+1 vorwaerts, -1 rueckwaerts). Wird im Interrupt\n
+  SIG_ADC aufgerufen. NULL = keine.
+
+  \see
+  Interruptfunktion SIGNAL (SIG_ADC) in asuro.c\n
+  PoseInit() in pose.c
+*****************************************************************************/
+void (* volatile enchook) (unsigned char, signed char);
@@ -237,6 +237,10 @@
 #endif
 #include <stdlib.h>
 
+#ifndef F_CPU
+  #define F_CPU 8000000UL   /*!< Prozessortakt vom ASURO */
+#endif
+
 #define  FALSE  0
 #define  TRUE   1
 
@@ -247,6 +251,15 @@
 #define RED     2
 #define YELLOW  3
 
+/* Verhalten von SerWrite() bei vollem Sendepuffer */
+#define UART_TX_BLOCK     0   /*!< warten bis wieder Platz im Puffer ist */
+#define UART_TX_DROP      1   /*!< neue Zeichen verwerfen */
+#define UART_TX_OVERWRITE 2   /*!< aelteste Zeichen im Puffer verwerfen */
+
+/* UBRR Werte fuer eine Baudrate, gerundet (normal und mit U2X) */
+#define UART_UBRR(baud)     ((F_CPU + 8UL * (baud)) / (16UL * (baud)) - 1)
+#define UART_UBRR_U2X(baud) ((F_CPU + 4UL * (baud)) / (8UL * (baud)) - 1)
+
 /* neue Funktionen und Variablen*/
 #define LEFT    0
 #define RIGHT   1
@@ -262,6 +275,22 @@
 #define K5 (1<<1)
 #define K6 (1<<0)
 
+/* Ereignisse vom Tastentreiber (SwitchEvent) */
+#define SWITCH_PRESS    1   /*!< Taste(n) gedrueckt */
+#define SWITCH_RELEASE  2   /*!< Taste(n) losgelassen */
+#define SWITCH_HOLD     3   /*!< Taste(n) laenger als MY_SWITCH_HOLD ms gedrueckt */
+
+/*!
+ * \~english
+ * \brief switch event from the debounced switch driver
+ */
+typedef struct
+{
+  unsigned char type;                   /*!< SWITCH_PRESS, _RELEASE, _HOLD */
+  unsigned char keys;                   /*!< betroffene Tasten K1..K6 */
+  unsigned int  time;                   /*!< Gettime() in ms (untere 16 Bit) */
+} switch_event_t;
+
 /* --- Globale Variablen -----------------------------------*/
 /*!
  * Asuro Lib Versions String
@@ -294,6 +323,49 @@ extern volatile int switched;
  */
 extern volatile int encoder[2];
 
+/*
+ * Vorzeichenbehaftete 32-Bit Odometrie Zaehler, Richtung aus MotorDir().
+ * enctick[0] links, enctick[1] = rechts.
+ */
+/*!
+ * \~english
+ * \brief signed 32 bit odometry tick count, direction from MotorDir()
+ * read with EncoderSnapshot() / EncoderDelta(), never reset
+ */
+extern volatile long enctick[2];
+
+/*
+ * Zeitpunkt des letzten Odometrie Ticks in 1/36 ms (Timer 2 Takt).
+ */
+/*!
+ * \~english
+ * \brief time of the last odometry tick in 1/36 ms (timer 2 clock, 16 bit)
+ * \see EncoderSpeedUpdate
+ */
+extern volatile unsigned int enctime[2];
+
+/*
+ * Rueckruffunktion fuer jeden Odometrie Tick, wird im Interrupt SIG_ADC
+ * aufgerufen (Seite, Richtung +1/-1).
+ */
+/*!
+ * \~english
+ * \brief called on every odometry tick in the ADC interrupt
+ *        with the side (LEFT, RIGHT) and direction (+1, -1)
+ * \see PoseInit
+ */
+extern void (* volatile enchook)(unsigned char, signed char);
+
+/*!
+ * \~english
+ * \brief consistent copy of both tick counters and the time
+ */
+typedef struct
+{
+  long          tick [2];               /*!< enctick[LEFT], enctick[RIGHT] */
+  unsigned long time;                   /*!< Gettime() in ms */
+} encoder_snapshot_t;
+
 /*
  * Counter fuer 36kHz.
  * Wird in der Interrupt Funktion SIG_OVERFLOW2 hochgezaehlt\n
@@ -316,6 +388,99 @@ extern volatile unsigned long timebase;
  */
 extern volatile int autoencode;
 
+/*
+ * ADC Sequencer (adc.c, Interrupt SIG_ADC in asuro.c)
+ */
+#define ADC_CHANNELS 6      /*!< ADC0..ADC5 */
+#define ADC_SCAN_MAX 6      /*!< maximale Laenge der Kanalliste */
+#define ADC_ONESHOT_NONE 0xFF /*!< adconeshot: keine Einzelmessung angefordert */
+
+/*!
+ * \~english
+ * \brief latest 10 bit value of every ADC channel (index = ADC channel)
+ * use AdcValue() to read it atomically
+ */
+extern volatile unsigned int adcvalue[ADC_CHANNELS];
+/*!
+ * \~english
+ * \brief incremented with every new value in adcvalue[]
+ */
+extern volatile unsigned char adcseq[ADC_CHANNELS];
+/*
+ * Bit n gesetzt: adcvalue[n] wurde seit AdcScanStart() gemessen
+ */
+extern volatile unsigned char adcvalid;
+/*
+ * Kanalliste des Sequencers, die Radsensoren werden immer eingeschoben
+ */
+extern volatile unsigned char adcscan[ADC_SCAN_MAX];
+extern volatile unsigned char adcscanlen;
+/*
+ * ADMUX Wert fuer eine Einzelmessung im naechsten Listenplatz (AdcRead())
+ */
+extern volatile unsigned char adconeshot;
+/*
+ * TRUE, solange der Sequencer laeuft
+ */
+extern volatile unsigned char adcscanon;
+/*
+ * Oversampling je Kanal: 4^adcosr[n] Messungen (0..ADC_OSR_MAX)
+ */
+#define ADC_OSR_MAX 3
+extern volatile unsigned char adcosr[ADC_CHANNELS];
+/*!
+ * \~english
+ * \brief oversampled value of every ADC channel with 10 + adcosr[n] bits
+ * use AdcValueExt() to read it atomically
+ */
+extern volatile unsigned int adcext[ADC_CHANNELS];
+extern volatile unsigned int adcacc[ADC_CHANNELS];
+extern volatile unsigned char adccnt[ADC_CHANNELS];
+/*
+ * Fremdlichtkompensation der Liniensensoren
+ */
+extern volatile unsigned char linecomp;
+extern volatile int linediff[2];
+extern volatile unsigned char lineseq[2];
+/*
+ * Rueckruffunktion je ADC-Kanal, wird im Interrupt SIG_ADC aufgerufen
+ */
+extern void (* volatile adchook[ADC_CHANNELS]) (unsigned int);
+/*
+ * Obergrenze fuer MotorSpeed(), 255 = keine Begrenzung
+ */
+extern volatile unsigned char pwmlimit;
+/*
+ * Kennlinie der Motoren (MotorCalibrate(), MotorLinSet())
+ */
+#define MOTOR_LIN_POINTS 17
+extern volatile unsigned char motorlin;
+extern unsigned char motorlintab[2][MOTOR_LIN_POINTS];
+extern unsigned int motorvmax;
+extern unsigned int motorffgain;
+/*
+ * Groesster OCR1A/OCR1B Wert der Motor-PWM (MotorPwmMode())
+ */
+extern volatile unsigned int motorpwmtop;
+/*
+ * Schrittweite der Motor-Rampe je Regeltakt, 0 = aus (MotorSlew())
+ */
+extern volatile unsigned int motorslew;
+/*
+ * Ausgleich der Batteriespannung: Nennspannung in mV, 0 = aus (BatteryCompensate())
+ */
+extern volatile unsigned int motorvnom;
+/*
+ * Gefilterte Batteriespannung in mV aus BatteryMonitor(), 0 = noch keine
+ */
+extern volatile unsigned int motorvmv;
+/*
+ * Selbstkalibrierende Odometrie: Huellkurven je Rad (10 Bit ADC * 16)
+ */
+extern volatile unsigned char odoauto;
+extern volatile unsigned int odomin[2];
+extern volatile unsigned int odomax[2];
+
 /* --- Funktions Prototypen -----------------------------------*/
 
 /*!
@@ -368,6 +533,54 @@ void EncoderStop(void);
  * \brief stop counting odometry sensor ticks
  */
 void EncoderStart(void);
+/*!
+ * \~english
+ * \brief adaptive odometry thresholds from min/max envelopes
+ * \param status ON: track the encoder disk contrast, OFF: MY_ODO_xxx constants
+ */
+void EncoderAutoThreshold(unsigned char status);
+/*!
+ * \~english
+ * \brief signal quality of an odometry sensor
+ * \param side LEFT or RIGHT
+ * \return contrast between light and dark envelope in 10 bit ADC steps,
+ *         no ticks are counted below MY_ODO_MIN_CONTRAST
+ */
+unsigned int EncoderQuality(unsigned char side);
+/*!
+ * \~english
+ * \brief read both signed tick counters and the time without tearing
+ * \param snap snapshot
+ */
+void EncoderSnapshot(encoder_snapshot_t *snap);
+/*!
+ * \~english
+ * \brief ticks since the last snapshot, snap is updated
+ * \param snap last snapshot (from EncoderSnapshot or EncoderDelta)
+ * \param delta delta[LEFT], delta[RIGHT] signed ticks
+ * \return elapsed time in ms
+ */
+unsigned int EncoderDelta(encoder_snapshot_t *snap, long *delta);
+/*!
+ * \~english
+ * \brief update the wheel speed estimate from the tick time stamps,
+ *        call every few ms (done by the speed control tick)
+ */
+void EncoderSpeedUpdate(void);
+/*!
+ * \~english
+ * \brief estimated wheel speed
+ * \param side LEFT or RIGHT
+ * \return signed speed in ticks/s
+ */
+int EncoderSpeed(unsigned char side);
+/*!
+ * \~english
+ * \brief estimated wheel speed
+ * \param side LEFT or RIGHT
+ * \return signed speed in mm/s
+ */
+int EncoderSpeedMm(unsigned char side);
 
 /**************** Encoder Funktionen encoder.c **************/
 /*!
@@ -379,11 +592,23 @@ void EncoderStart(void);
  *                 if distanse is zero, then the function will work as Turn.
  * \param degree degrees to turn. positive = turn right, negative = turn left. range: -360..360
  * \param speed motor speed. range: 0..255
+ * \note blocks until the motion queue (motion.h) is empty,
+ *       use MotionGo/MotionTurn to keep the program running
  */
 void GoTurn(int distance, int degree, int speed);
 // aus Nostalgiegruenden Defines fuer alte Funktionsnamen 
 #define Go(distance,speed) GoTurn(distance,0,speed)
 #define Turn(degree,speed) GoTurn(0,degree,speed)
+/*!
+ * \~english
+ * \brief drive an arc without stopping
+ * \param radius radius of the robot centre in mm, always forward (sign is ignored)
+ * \param degree angle, positive = turn right, negative = turn left
+ * \param speed speed of the outer wheel, range 0..255 as for GoTurn
+ * \note blocks until the motion queue (motion.h) is empty,
+ *       use MotionArc to keep the program running
+ */
+void GoArc(int radius, int degree, int speed);
 
 /**************** A/D Wandler Funktionen adc.c **************/
 /*!
@@ -405,6 +630,80 @@ void LineData(unsigned int *data);
  */
 void OdometryData(unsigned int *data);
 
+/*!
+ * \~english
+ * \brief start the interrupt driven ADC sequencer
+ * Battery, LineData, OdometryData and PollSwitch then return cached values
+ */
+void AdcScanStart(void);
+/*!
+ * \~english
+ * \brief stop the ADC sequencer, the getters block again
+ */
+void AdcScanStop(void);
+/*!
+ * \~english
+ * \brief set the channel list of the sequencer (wheel sensors are always inserted)
+ * \param list ADC channels: IR_LEFT, IR_RIGHT, SWITCH, BATTERIE
+ * \param n number of channels (max. ADC_SCAN_MAX)
+ */
+void AdcScanList(const unsigned char *list, unsigned char n);
+/*!
+ * \~english
+ * \brief latest value of an ADC channel from the sequencer
+ * \param channel ADC channel 0..5
+ * \return 10 bit value
+ */
+unsigned int AdcValue(unsigned char channel);
+/*!
+ * \~english
+ * \brief read an ADC channel, cached if the sequencer measures it
+ * \param mux ADMUX value (channel and reference)
+ * \param settle delay before a direct conversion in 1/36kHz
+ * \return 10 bit value
+ */
+unsigned int AdcRead(unsigned char mux, unsigned char settle);
+/*!
+ * \~english
+ * \brief TRUE if the sequencer currently measures the given channel
+ */
+unsigned char AdcScanned(unsigned char channel);
+/*!
+ * \~english
+ * \brief set oversampling of an ADC channel, 4^n conversions are accumulated
+ * \param channel ADC channel 0..5
+ * \param n 0 (off) .. ADC_OSR_MAX
+ */
+void AdcOversample(unsigned char channel, unsigned char n);
+/*!
+ * \~english
+ * \brief oversampled value of an ADC channel
+ * \param channel ADC channel 0..5
+ * \return value with 10 + n bits resolution (n see AdcOversample)
+ */
+unsigned int AdcValueExt(unsigned char channel);
+/*!
+ * \~english
+ * \brief switch ambient light compensation of the line sensors on or off
+ * the sequencer then owns the FrontLED and measures lit and dark samples
+ * \param status ON or OFF
+ */
+void LineCompensation(unsigned char status);
+/*!
+ * \~english
+ * \brief read the ambient light compensated line sensors (lit - dark)
+ * \param data data[0] left, data[1] right
+ * \return TRUE if both values are new since the last call, FALSE if stale
+ */
+unsigned char LineDataComp(int *data);
+/*!
+ * \~english
+ * \brief install a callback for new values of an ADC channel (runs in the ISR)
+ * \param channel ADC channel 0..5
+ * \param hook function called with the new 10 bit value, NULL to remove
+ */
+void AdcHook(unsigned char channel, void (*hook)(unsigned int));
+
 // aus Nostalgiegruenden Defines fuer alte Funktionsnamen 
 #define Batterie Battery 
 #define OdometrieData OdometryData
@@ -447,26 +746,132 @@ inline void MotorDir(unsigned char left_dir, unsigned char right_dir);
  */
 
 inline void MotorSpeed(unsigned char left_speed, unsigned char right_speed);
+/*!
+ * \~english
+ * \brief sets motor speed with 16 bit resolution. range: 0..65535
+ *        (the PWM resolution depends on MotorPwmMode)
+ * \param left_speed left motor
+ * \param right_speed right motor
+ */
+void MotorSpeed16(unsigned int left_speed, unsigned int right_speed);
+/*!
+ * \~english
+ * \brief select resolution and frequency of the motor PWM (timer 1)
+ * \param mode MOTOR_PWM_8BIT, MOTOR_PWM_9BIT, MOTOR_PWM_10BIT, MOTOR_PWM_20KHZ
+ */
+void MotorPwmMode(unsigned char mode);
+/*!
+ * \~english
+ * \brief convert a 16 bit speed (0..65535) into an OCR1A/OCR1B value
+ */
+unsigned int MotorPwmOcr(unsigned int speed);
+/*!
+ * \~english
+ * \brief set the ramp step per control tick (0..65535 scale), 0 = off
+ *        (see MotorSlew in ctrl.h, which also starts the tick)
+ */
+void MotorSlewSet(unsigned int step);
+/*!
+ * \~english
+ * \brief one ramp step, called from the control tick interrupt
+ */
+void MotorSlewTick(void);
 
 /**************** Motorsteuerungs Funktionen motor.c **************/
 void SetMotorPower(int8_t leftpwm, int8_t rightpwm);
+/*!
+ * \~english
+ * \brief sets motor speed and direction with 16 bit resolution
+ * \param leftpwm left motor, -32767..32767
+ * \param rightpwm right motor, -32767..32767
+ */
+void SetMotorPower16(int leftpwm, int rightpwm);
+/*!
+ * \~english
+ * \brief measure both motors with the odometry and switch on the
+ *        linearisation in MotorSpeed() (drives straight ahead for about 1 m)
+ * \return speed in mm/s at full effort, 0 = failed (no odometry ticks)
+ */
+unsigned int MotorCalibrate(void);
+/*!
+ * \~english
+ * \brief load a stored linearisation table or switch it off
+ * \param left 17 PWM values for the left motor, NULL = linearisation off
+ * \param right 17 PWM values for the right motor
+ * \param vmax speed in mm/s at full effort
+ */
+void MotorLinSet(const unsigned char *left, const unsigned char *right, unsigned int vmax);
 
 /******************** Low Level UART Funktionen uart.c ************/
 /*!
  * \~english
  * \brief Send Data to UART
+ * queues the data in the transmit buffer and returns immediately
  * \param data pointer to data
  * \param length data count
  */
 void SerWrite(unsigned char *data,unsigned char length);
+/*!
+ * \~english
+ * \brief wait until the transmit buffer is empty and the transmitter is off
+ */
+void SerFlush(void);
+/*!
+ * \~english
+ * \brief what SerWrite does if the transmit buffer is full
+ * \param policy UART_TX_BLOCK, UART_TX_DROP, UART_TX_OVERWRITE
+ */
+void SerTxPolicy(unsigned char policy);
+/*!
+ * \~english
+ * \brief function called (in interrupt context) after the last byte
+ * has been sent and the transmitter was switched off
+ * \param hook callback, 0 to remove
+ */
+void SerTxDoneHook(void (*hook)(void));
 /*!
  * \~english
  * \brief Receive Data from UART
  * \param data pointer to data
  * \param length data count
- * \timeout timeout count, 0 meens blocking mode 
+ * \param timeout max. ms to wait for each character, 0 meens blocking mode
+ * \return number of characters received, less than length on timeout
  */
-void SerRead(unsigned char *data, unsigned char length, unsigned int timeout);
+unsigned char SerRead(unsigned char *data, unsigned char length, unsigned int timeout);
+/*!
+ * \~english
+ * \brief number of received characters waiting in the receive buffer
+ */
+unsigned char SerAvailable(void);
+/*!
+ * \~english
+ * \brief read already received characters, never waits
+ * \param data pointer to data
+ * \param length max. data count
+ * \return number of characters read
+ */
+unsigned char SerReadSome(unsigned char *data, unsigned char length);
+/*!
+ * \~english
+ * \brief receive error counters
+ * \param overrun lost characters (buffer full or DOR)
+ * \param frame characters dropped because of a framing error
+ */
+void SerRxErrors(unsigned int *overrun, unsigned int *frame);
+/*!
+ * \~english
+ * \brief set the baud rate, U2X is used if it gives the smaller error
+ * \param baud baud rate, e.g. 2400 (IR link) .. 38400 (wired)
+ * \return baud rate error in 1/10 percent
+ */
+int SerBaud(unsigned long baud);
+/*!
+ * \~english
+ * \brief baud rate error SerBaud would achieve, registers are not changed
+ * \param baud baud rate
+ * \return baud rate error in 1/10 percent
+ */
+int SerBaudError(unsigned long baud);
 
 /**************** Print Funktionen serielle Ausgabe print.c ********/
 void UartPutc(unsigned char zeichen);
@@ -497,6 +902,19 @@ void StartSwitch(void);
  * \see StartSwitch
  */
 void StopSwitch(void);
+/*!
+ * \~english
+ * \brief start the debounced switch driver in the ADC sequencer
+ * PollSwitch then returns the debounced state without blocking
+ */
+void SwitchInit(void);
+/*!
+ * \~english
+ * \brief get the next switch event
+ * \param ev event
+ * \return TRUE if an event was returned, FALSE if the queue is empty
+ */
+unsigned char SwitchEvent(switch_event_t *ev);
 
 /**************** Soundausgabe sound.c **************************/
 void Sound(uint16_t freq, uint16_t duration_msec, uint8_t amplitude);
@@ -520,6 +938,12 @@ void Sound(uint16_t freq, uint16_t duration_msec, uint8_t amplitude);
 #define RED_LED     (1 << PD2)            /*!< PD2 Port fuer Rote Status LED */
 
 #define PWM       (1 << PB1) | (1 << PB2) /*!< PB1, PB2 Ports fuer Pulsweitenmodulation der Motor Geschwindigkeit */
+
+/* Motor-PWM, siehe MotorPwmMode() */
+#define MOTOR_PWM_8BIT  0   /*!< 256 Stufen, 1.96 kHz (Init()) */
+#define MOTOR_PWM_9BIT  1   /*!< 512 Stufen, 15.6 kHz */
+#define MOTOR_PWM_10BIT 2   /*!< 1024 Stufen, 7.8 kHz */
+#define MOTOR_PWM_20KHZ 3   /*!< 400 Stufen, 20 kHz */
 #define RIGHT_DIR (1 << PB4) | (1 << PB5) /*!< PB4, PB5 Ports fuer Drehrichtung rechter Motor */
 #define LEFT_DIR  (1 << PD4) | (1 << PD5) /*!< PD4, PD5 Ports fuer Drehrichtung linker Motor */
 
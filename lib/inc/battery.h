@@ -0,0 +1,85 @@
+/*!
+  \file battery.h
+  \brief Definitionen und Funktionen fuer die Batterieueberwachung.
+
+  \par Batterieueberwachung
+  BatteryMonitor() haengt sich mit AdcHook() an den Batteriekanal des\n
+  ADC Sequencers. Jeder neue Wert wird in mV umgerechnet (5.5 mV pro\n
+  Schritt, also adc * 11 / 2), gleitend ueber MY_BATTERY_AVG Werte\n
+  gemittelt und mit der Warn- und Abschaltschwelle verglichen. Wechselt\n
+  der Zustand, wird die Rueckruffunktion aufgerufen. Die kleinste Spannung\n
+  bei laufenden Motoren wird ebenfalls gemerkt.
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            BatteryCompensate()
+ */
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+
+#ifndef BATTERY_H
+#define BATTERY_H
+
+/* Zustaende der Batterieueberwachung */
+#define BATTERY_OK      0   /*!< Spannung ueber der Warnschwelle */
+#define BATTERY_WARN    1   /*!< Spannung unter der Warnschwelle */
+#define BATTERY_CUTOFF  2   /*!< Spannung unter der Abschaltschwelle (bleibt) */
+
+/*!
+ * \~english
+ * \brief start the background battery monitor
+ * \param warn warn threshold in mV
+ * \param cutoff cutoff threshold in mV
+ * \param callback called with BATTERY_OK/WARN/CUTOFF on every change (in the ISR), may be NULL
+ */
+void BatteryMonitor(unsigned int warn, unsigned int cutoff,
+                    void (*callback)(unsigned char level));
+/*!
+ * \~english
+ * \brief stop the battery monitor
+ */
+void BatteryMonitorStop(void);
+/*!
+ * \~english
+ * \brief filtered battery voltage
+ * \return moving average in mV
+ */
+unsigned int BatteryMv(void);
+/*!
+ * \~english
+ * \brief lowest filtered battery voltage while the motors were running
+ * \return mV, 0xFFFF if not yet measured
+ */
+unsigned int BatteryMinMv(void);
+/*!
+ * \~english
+ * \brief reset the minimum of BatteryMinMv()
+ */
+void BatteryMinReset(void);
+/*!
+ * \~english
+ * \brief current state of the battery monitor
+ * \return BATTERY_OK, BATTERY_WARN or BATTERY_CUTOFF
+ */
+unsigned char BatteryLevel(void);
+/*!
+ * \~english
+ * \brief limit the motor PWM when the cutoff threshold is reached
+ * \param pwm maximum PWM value at cutoff, 255 = no limit
+ */
+void BatteryCutoffPwm(unsigned char pwm);
+/*!
+ * \~english
+ * \brief scale the motor PWM by nominal / battery voltage
+ * \param nominal nominal voltage in mV, 0 = off
+ */
+void BatteryCompensate(unsigned int nominal);
+
+#endif /* BATTERY_H */
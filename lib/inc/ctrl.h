@@ -0,0 +1,96 @@
+/*!
+  \file ctrl.h
+  \brief Definitionen und Funktionen fuer die Geschwindigkeitsregelung.
+
+  \par Geschwindigkeitsregelung
+  CtrlInit() startet Timer 0 als festen Regeltakt mit CTRL_HZ. In jedem\n
+  Takt wird mit EncoderSpeedUpdate() die Geschwindigkeit beider Raeder\n
+  gemessen und je Rad ein PID-Regler mit Vorsteuerung gerechnet. Das\n
+  Ergebnis wird mit MotorDir() und MotorSpeed() ausgegeben. Das eigene\n
+  Programm gibt nur noch mit CtrlSpeed() die Sollwerte in mm/s vor und\n
+  kann danach weiterarbeiten.
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            CtrlHook(), CtrlActive()
+  \version  V003 - 17.10.2026\n
+            MotorSlew()
+  \version  V004 - 17.10.2026\n
+            CtrlBackground()
+ */
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+
+#ifndef CTRL_H
+#define CTRL_H
+
+#define CTRL_HZ       125   /*!< Regeltakt in Hz (8 ms) */
+
+/*!
+ * \~english
+ * \brief start the closed loop speed control tick (timer 0, CTRL_HZ)
+ *        the odometry (EncoderInit) is started if necessary
+ */
+void CtrlInit(void);
+/*!
+ * \~english
+ * \brief stop the speed control tick and the motors
+ */
+void CtrlStop(void);
+/*!
+ * \~english
+ * \brief set the target wheel speeds
+ * \param left target speed of the left wheel in mm/s, negative = backward
+ * \param right target speed of the right wheel in mm/s, negative = backward
+ */
+void CtrlSpeed(int left, int right);
+/*!
+ * \~english
+ * \brief set the PID gains (fixed point, 256 = 1 PWM step per mm/s)
+ * \param kp proportional gain
+ * \param ki integral gain per control tick
+ * \param kd derivative gain per control tick (on the measured speed)
+ */
+void CtrlGains(int kp, int ki, int kd);
+/*!
+ * \~english
+ * \brief current controller output
+ * \param side LEFT or RIGHT
+ * \return PWM value -255..255, negative = backward
+ */
+int CtrlPwm(unsigned char side);
+/*!
+ * \~english
+ * \brief function called on every control tick before the PID step
+ *        (runs in the timer 0 interrupt, may call CtrlSpeed)
+ * \param fn callback, NULL = none
+ */
+void CtrlHook(void (*fn)(void));
+/*!
+ * \~english
+ * \brief is the speed control tick running?
+ * \return TRUE after CtrlInit, FALSE after CtrlStop
+ */
+unsigned char CtrlActive(void);
+/*!
+ * \~english
+ * \brief ramp the motor PWM in the background (timer 0, also without CtrlInit)
+ * \param ms time from stop to full PWM in ms, 0 = no ramp
+ */
+void MotorSlew(unsigned int ms);
+/*!
+ * \~english
+ * \brief function called on every timer 0 tick, also without CtrlInit
+ *        (runs in the timer 0 interrupt with interrupts enabled)
+ * \param fn callback, NULL = none
+ */
+void CtrlBackground(void (*fn)(void));
+
+#endif /* CTRL_H */
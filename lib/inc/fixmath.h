@@ -0,0 +1,98 @@
+/*!
+  \file fixmath.h
+  \brief Definitionen und Funktionen fuer die Festkomma-Arithmetik.
+
+  \par Festkomma-Arithmetik
+  Rechnen ohne float: fix8_t hat 8 Bit hinter dem Komma (Q8.8, Bereich\n
+  -128..127.996, Aufloesung 0.0039), fix16_t hat 16 Bit hinter dem Komma\n
+  (Q16.16, Bereich -32768..32767.99998). Addition und Subtraktion gehen\n
+  direkt mit + und -, Multiplikation und Division ueber die Funktionen,\n
+  die bei Ueberlauf auf den groessten Wert begrenzen.\n
+  Winkel sind 16-Bit-Werte mit 65536 = 360 Grad (wie pose_t.theta). Der\n
+  Ueberlauf bei 360 Grad ist damit gewollt und kostet nichts.\n
+  Sinus und Arcustangens kommen aus Tabellen im Flash, die der Compiler\n
+  beim Uebersetzen berechnet.
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+ */
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+
+#ifndef FIXMATH_H
+#define FIXMATH_H
+
+/*! Festkommazahl mit 8 Bit hinter dem Komma */
+typedef int  fix8_t;
+/*! Festkommazahl mit 16 Bit hinter dem Komma */
+typedef long fix16_t;
+
+/*! Konstante in fix8_t, z.B. FIX8 (1.5) (nur fuer Konstanten, rechnet der Compiler) */
+#define FIX8(x)   ((fix8_t) ((x) * 256.0 + ((x) < 0 ? -0.5 : 0.5)))
+/*! Konstante in fix16_t, z.B. FIX16 (3.14159) */
+#define FIX16(x)  ((fix16_t) ((x) * 65536.0 + ((x) < 0 ? -0.5 : 0.5)))
+/*! Ganzzahliger Anteil, gerundet */
+#define FIX8_INT(a)   ((int) (((a) + 0x80) >> 8))
+/*! Ganzzahliger Anteil, gerundet */
+#define FIX16_INT(a)  ((int) (((a) + 0x8000L) >> 16))
+/*! Winkel in Grad -> 65536 = 360 Grad */
+#define FIX_ANGLE(deg)  ((unsigned int) (((long) (deg) * 65536L) / 360))
+
+/*!
+ * \~english
+ * \brief multiply two Q8.8 values (rounded, saturated)
+ */
+fix8_t Fix8Mul(fix8_t a, fix8_t b);
+/*!
+ * \~english
+ * \brief divide two Q8.8 values (rounded, saturated, b = 0 gives the maximum)
+ */
+fix8_t Fix8Div(fix8_t a, fix8_t b);
+/*!
+ * \~english
+ * \brief multiply two Q16.16 values (rounded, saturated)
+ */
+fix16_t Fix16Mul(fix16_t a, fix16_t b);
+/*!
+ * \~english
+ * \brief divide two Q16.16 values (rounded, saturated, b = 0 gives the maximum)
+ */
+fix16_t Fix16Div(fix16_t a, fix16_t b);
+/*!
+ * \~english
+ * \brief integer square root, rounded down
+ */
+unsigned int ISqrt(unsigned long x);
+/*!
+ * \~english
+ * \brief square root of a Q8.8 value, 0 for negative values
+ */
+fix8_t Fix8Sqrt(fix8_t a);
+/*!
+ * \~english
+ * \brief sine
+ * \param angle 65536 = 360 degree
+ * \return sin * 32767
+ */
+int FixSin(unsigned int angle);
+/*!
+ * \~english
+ * \brief cosine
+ * \param angle 65536 = 360 degree
+ * \return cos * 32767
+ */
+int FixCos(unsigned int angle);
+/*!
+ * \~english
+ * \brief angle of the vector (x, y)
+ * \return 65536 = 360 degree, counter clockwise from x, 0 for (0, 0)
+ */
+unsigned int FixAtan2(int y, int x);
+
+#endif /* FIXMATH_H */
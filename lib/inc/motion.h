@@ -0,0 +1,108 @@
+/*!
+  \file motion.h
+  \brief Definitionen und Funktionen fuer den Bewegungsablauf im Hintergrund.
+
+  \par Bewegungsablauf
+  MotionGo(), MotionTurn() und MotionArc() haengen Fahrstrecken, Drehungen\n
+  und Kreisboegen an eine Warteschlange an und kehren sofort zurueck. Die\n
+  Abschnitte werden nacheinander im Regeltakt von ctrl.c abgefahren, ohne\n
+  Pause dazwischen. Das eigene Programm kann derweil Taster, RC5 oder die\n
+  serielle Schnittstelle bedienen und mit MotionBusy() nachsehen, wie viele\n
+  Abschnitte noch offen sind.\n
+  Beim Anhaengen wird die ganze Warteschlange vorausberechnet: zwischen\n
+  Abschnitten, die ineinander uebergehen (Gerade - Gerade, Gerade - Bogen),\n
+  wird nur so weit gebremst, wie es der naechste Abschnitt verlangt.\n
+  Mit MotionBlend() werden Ecken aus Gerade - Drehung - Gerade als\n
+  Kreisbogen durchfahren.
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            MotionAccel(), Trapezprofil
+  \version  V003 - 17.10.2026\n
+            MotionBlend(), Vorausschau ueber die Warteschlange
+ */
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+
+#ifndef MOTION_H
+#define MOTION_H
+
+/* Arten der Abschnitte */
+#define MOTION_GO     1   /*!< Strecke in mm */
+#define MOTION_TURN   2   /*!< Drehung auf der Stelle in Grad */
+#define MOTION_ARC    3   /*!< Kreisbogen mit Radius in mm und Winkel in Grad */
+
+/*!
+ * \~english
+ * \brief start the speed controller and attach the motion queue to it
+ *        (called by the other Motion functions if necessary)
+ */
+void MotionInit(void);
+/*!
+ * \~english
+ * \brief queue a straight segment
+ * \param distance distance in mm, negative = backward
+ * \param speed speed in mm/s
+ * \return segment id 1..255, 0 = queue full
+ */
+unsigned char MotionGo(int distance, int speed);
+/*!
+ * \~english
+ * \brief queue a turn on the spot
+ * \param degree angle, positive = turn right, negative = turn left
+ * \param speed wheel speed in mm/s
+ * \return segment id 1..255, 0 = queue full
+ */
+unsigned char MotionTurn(int degree, int speed);
+/*!
+ * \~english
+ * \brief queue a forward arc
+ * \param radius radius of the robot centre in mm, sign is ignored
+ * \param degree angle, positive = turn right, negative = turn left
+ * \param speed speed of the outer wheel in mm/s
+ * \return segment id 1..255, 0 = queue full
+ */
+unsigned char MotionArc(int radius, int degree, int speed);
+/*!
+ * \~english
+ * \brief number of queued segments including the running one
+ * \return 0 = idle
+ */
+unsigned char MotionBusy(void);
+/*!
+ * \~english
+ * \brief wait until all queued segments are done
+ */
+void MotionWait(void);
+/*!
+ * \~english
+ * \brief drop all queued segments and stop the robot
+ */
+void MotionCancel(void);
+/*!
+ * \~english
+ * \brief function called when a segment is done (in the interrupt)
+ * \param fn callback with the segment id, NULL = none
+ */
+void MotionCallback(void (*fn)(unsigned char id));
+/*!
+ * \~english
+ * \brief acceleration of the trapezoidal speed profile
+ * \param a acceleration in mm/s^2, 0 = no profile (full speed at once)
+ */
+void MotionAccel(int a);
+/*!
+ * \~english
+ * \brief round corners (straight, turn, straight) with an arc
+ * \param radius largest corner radius in mm, 0 = stop and turn on the spot
+ */
+void MotionBlend(int radius);
+
+#endif /* MOTION_H */
@@ -42,6 +42,52 @@
             MY_MOTOR_DIFF zum ausgleichen unterschiedlicher Motoren.
             V003 - 20.02.2007 - m.a.r.v.i.n\n
             Kommentare aus my struktur uebernommen
+  \version  V004 - 17.10.2026\n
+            Neuer Define\n
+            MY_UART_TX_SIZE Groesse vom Sendepuffer der seriellen Schnittstelle.\n
+            MY_UART_RX_SIZE, MY_UART_HALFDUPLEX fuer den Empfangspuffer.\n
+            MY_UART_BAUD, MY_UART_U2X Baudrate der seriellen Schnittstelle.
+  \version  V005 - 17.10.2026\n
+            Neuer Define\n
+            MY_BATTERY_AVG, MY_BATTERY_HYST fuer die Batterieueberwachung.
+  \version  V006 - 17.10.2026\n
+            Neuer Define\n
+            MY_SWITCH_DEBOUNCE, MY_SWITCH_HOLD, MY_SWITCH_QUEUE fuer den
+            Tastentreiber.
+  \version  V007 - 17.10.2026\n
+            Neuer Define\n
+            MY_ODO_MIN_CONTRAST, MY_ODO_ENV_DECAY fuer die selbstkalibrierende
+            Odometrie.
+  \version  V008 - 17.10.2026\n
+            Neuer Define\n
+            MY_ENC_SPEED_WINDOW, MY_ENC_SPEED_TIMEOUT fuer die Messung der
+            Radgeschwindigkeit.
+  \version  V009 - 17.10.2026\n
+            Neuer Define\n
+            MY_CTRL_KP, MY_CTRL_KI, MY_CTRL_KD, MY_CTRL_FF_OFFSET,
+            MY_CTRL_FF_GAIN fuer die Geschwindigkeitsregelung.
+  \version  V010 - 17.10.2026\n
+            Neuer Define\n
+            MY_MOTION_QUEUE fuer den Bewegungsablauf.
+  \version  V011 - 17.10.2026\n
+            Neuer Define\n
+            MY_MOTION_ACCEL, MY_MOTION_VMIN fuer das Trapezprofil.
+  \version  V012 - 17.10.2026\n
+            Neuer Define\n
+            MY_MOTOR_CAL_SETTLE, MY_MOTOR_CAL_MEASURE fuer MotorCalibrate().\n
+            MY_MOTOR_DIFF wird jetzt in MotorSpeed() benutzt.
+  \version  V013 - 17.10.2026\n
+            Neuer Define\n
+            MY_BATTERY_NOMINAL fuer BatteryCompensate().
+  \version  V014 - 17.10.2026\n
+            Neuer Define\n
+            MY_MOTION_KSYNC fuer den Gleichlauf der Raeder in motion.c.
+  \version  V015 - 17.10.2026\n
+            Neuer Define\n
+            MY_MOTION_VJUMP, MY_MOTION_BLEND fuer die Vorausschau in motion.c.
+  \version  V016 - 17.10.2026\n
+            Neuer Define\n
+            MY_SWITCH_SETTLE Ladezeit der Taster im ADC Sequencer.
 *****************************************************************************/
 /***************************************************************************
 *                                                                         *
@@ -95,6 +141,62 @@
     Sie MUESSEN KLEINER als die Werte fuer MY_ODO_LIGHT_VALUE_R sein.
 */
 #define MY_ODO_DARK_VALUE_R      140    /*!< Encoderschwellwert fuer Dunkel (rechte Seite) */
+/*! Kleinster Abstand zwischen Hell- und Dunkel-Huellkurve (10 Bit ADC)\n
+    im selbstkalibrierenden Betrieb (EncoderAutoThreshold()). Darunter wird\n
+    nicht gezaehlt, damit ein stehendes Rad durch Rauschen keine Ticks\n
+    erzeugt. Die Hysterese ist mindestens so breit wie dieser Wert.\n
+    Er sollte groesser als das Rauschen (Spitze-Spitze) der Radsensoren sein.
+*/
+#define MY_ODO_MIN_CONTRAST       40    /*!< Mindestkontrast der Encoderscheibe */
+/*! Abklingen der Huellkurven. Alle 16 Messungen wird der Abstand zur\n
+    Messung um 1/2^n verkleinert. Bei 6 ist die Zeitkonstante etwa 0.4 s.
+*/
+#define MY_ODO_ENV_DECAY           6    /*!< Abklingen der Huellkurven (Shift) */
+
+/* Werte fuer die Geschwindigkeitsmessung EncoderSpeedUpdate() */
+/*! Mindestzeit in ms zwischen zwei Flanken, ueber die die Geschwindigkeit\n
+    berechnet wird. Bei schnellen Raedern werden alle Ticks in diesem\n
+    Fenster gezaehlt, bei langsamen gilt die Periode eines Ticks.
+*/
+#define MY_ENC_SPEED_WINDOW       40    /*!< Messfenster in ms */
+/*! Ohne Tick fuer diese Zeit in ms gilt das Rad als stehend (max. 1800).
+*/
+#define MY_ENC_SPEED_TIMEOUT     500    /*!< Stillstand nach ms ohne Tick */
+
+/* Werte fuer die Geschwindigkeitsregelung in ctrl.c */
+/*! Verstaerkungen des PID-Reglers als Festkommawert: 256 entspricht\n
+    1 PWM-Schritt je mm/s Regelabweichung. KI und KD gelten je Regeltakt\n
+    (8 ms). Zur Laufzeit mit CtrlGains() aenderbar.
+*/
+#define MY_CTRL_KP               128    /*!< Proportionalanteil */
+#define MY_CTRL_KI                 8    /*!< Integralanteil je Takt */
+#define MY_CTRL_KD               128    /*!< Differentialanteil je Takt */
+/*! Vorsteuerung: PWM = MY_CTRL_FF_OFFSET + v * MY_CTRL_FF_GAIN / 256\n
+    mit v in mm/s. Der Offset ist die PWM, bei der die Raeder gerade\n
+    anlaufen, die Steigung ergibt sich aus der Geschwindigkeit bei 255.
+*/
+#define MY_CTRL_FF_OFFSET         50    /*!< Anlauf-PWM */
+#define MY_CTRL_FF_GAIN          128    /*!< PWM je mm/s * 256 */
+
+/* Werte fuer den Bewegungsablauf in motion.c */
+#define MY_MOTION_QUEUE            8    /*!< Abschnitte in der Warteschlange */
+/*! Beschleunigung fuer das Trapezprofil, mit MotionAccel() aenderbar.\n
+    Bis etwa 1000 mm/s^2 drehen die Raeder auf normalem Boden nicht durch.
+*/
+#define MY_MOTION_ACCEL          800    /*!< Beschleunigung in mm/s^2 */
+#define MY_MOTION_VMIN            30    /*!< Kriechgeschwindigkeit am Ziel mm/s */
+/*! Gleichlauf: Korrektur in mm/s je Tick, den ein Rad gegenueber dem\n
+    Verhaeltnis der Ziel-Ticks vorauseilt. 0 = nur Geschwindigkeiten im\n
+    Verhaeltnis.
+*/
+#define MY_MOTION_KSYNC            8    /*!< mm/s je Tick Abweichung */
+/*! Groesster Sprung der Radgeschwindigkeit am Uebergang zwischen zwei\n
+    Abschnitten, z.B. von der Geraden in einen Bogen. Bestimmt, wie weit\n
+    vor dem Uebergang gebremst wird.
+*/
+#define MY_MOTION_VJUMP           60    /*!< mm/s */
+/*! Eckenradius fuer MotionBlend() nach dem Start, 0 = an Ecken anhalten */
+#define MY_MOTION_BLEND            0    /*!< mm */
 
 /* Werte fr 12 Segmente Encoder */
 /*! Faktor zur Berechnung von Ticks um aus den in mm angegebenen Parameter
@@ -120,5 +222,75 @@
     Bei einem \n negativen Wert, wird der \n linke Motor \b verstaerkt.
   */
 #define MY_MOTOR_DIFF              0    /*!< 1/2 PLUS fuer Rechts, 1/2 MINUS fuer Links */
+/*! Zeiten je PWM-Stufe fuer MotorCalibrate() (17 Stufen).\n
+    Erst MY_MOTOR_CAL_SETTLE ms einschwingen, dann MY_MOTOR_CAL_MEASURE ms\n
+    messen (mindestens 8). Laengere Zeiten messen genauer, der Asuro\n
+    faehrt dann aber auch weiter.
+*/
+#define MY_MOTOR_CAL_SETTLE      150    /*!< Einschwingzeit in ms */
+#define MY_MOTOR_CAL_MEASURE     100    /*!< Messzeit in ms */
+
+/* Serielle Schnittstelle */
+/*! Groesse vom Sendepuffer in Byte.\n
+    Muss eine 2er Potenz sein (maximal 128). Eine ganze PrintInt() Zeile\n
+    mit Trennzeichen sollte hineinpassen, damit die Print Funktionen\n
+    nie warten muessen.
+*/
+#define MY_UART_TX_SIZE           32    /*!< Sendepuffer fuer SerWrite() */
+/*! Groesse vom Empfangspuffer in Byte.\n
+    Muss eine 2er Potenz sein (maximal 128).
+*/
+#define MY_UART_RX_SIZE           16    /*!< Empfangspuffer fuer SerRead() */
+/*! Halbduplex Betrieb.\n
+    Der IR-Empfaenger sieht das Licht der eigenen Sende-LED. Deshalb wird\n
+    der Empfaenger bei \b 1 waehrend des Sendens abgeschaltet.\n
+    Bei einer Kabelverbindung kann hier \b 0 eingetragen werden.
+*/
+#define MY_UART_HALFDUPLEX         1    /*!< Empfaenger beim Senden aus */
+/*! Baudrate, die Init() einstellt.\n
+    Der Originalwert ist \b 2400L. Mehr schafft der IR-Transceiver nicht.\n
+    Fuer eine Kabelverbindung an RXD/TXD sind 9600L..38400L moeglich.\n
+    Zur Laufzeit kann die Baudrate mit SerBaud() geaendert werden.
+*/
+#define MY_UART_BAUD           2400L    /*!< Baudrate nach Init() */
+/*! Doppelte Geschwindigkeit (U2X) fuer MY_UART_BAUD benutzen.\n
+    Bei 8 MHz liegt der Fehler fuer 4800..38400 Baud ohne U2X bei 0.16 %.\n
+    Nur 2400 Baud wird mit U2X genauer (-0.08 % mit UBRR = 416 statt\n
+    0.16 %). Der Originalwert ist \b 0 (UBRR = 0xCF). Siehe SerBaudError().
+*/
+#define MY_UART_U2X                0    /*!< 1 = U2X Bit setzen */
+
+/* Batterieueberwachung */
+/*! Anzahl der Batteriewerte im gleitenden Mittelwert von BatteryMv().\n
+    Muss eine 2er Potenz sein (maximal 64).
+*/
+#define MY_BATTERY_AVG             8    /*!< Werte im gleitenden Mittel */
+/*! Hysterese in mV. Eine Warnung wird erst zurueckgenommen, wenn die\n
+    Spannung wieder um diesen Wert ueber der Warnschwelle liegt.
+*/
+#define MY_BATTERY_HYST          100    /*!< Hysterese in mV */
+/*! Spannung in mV, bei der BatteryCompensate() die PWM unveraendert\n
+    laesst. Am besten die Spannung, bei der MotorCalibrate() bzw. die\n
+    eigenen Programme eingestellt wurden.
+*/
+#define MY_BATTERY_NOMINAL      4800    /*!< Nennspannung in mV */
+
+/* Tastentreiber */
+/*! Anzahl gleicher Messungen, bis ein Tastenzustand gilt (Entprellung).\n
+    Der ADC Sequencer misst die Taster etwa alle 2..3 ms.
+*/
+#define MY_SWITCH_DEBOUNCE         4    /*!< Messungen zum Entprellen */
+/*! Zeit in ms bis zum Ereignis SWITCH_HOLD (maximal 7000).
+*/
+#define MY_SWITCH_HOLD           500    /*!< Haltezeit in ms */
+/*! Groesse der Ereignis-Warteschlange. Muss eine 2er Potenz sein.
+*/
+#define MY_SWITCH_QUEUE            8    /*!< Ereignisse in der Warteschlange */
+/*! Zusaetzliche Einschwingmessungen fuer den Taster-Kanal im ADC Sequencer.\n
+    Nach SWITCH_ON laedt der Kondensator (1 + n) Wandlungen lang, je etwa\n
+    104 us. Bei 2 sind das 312 us, etwas mehr als das fruehere Sleep (10)\n
+    mit 278 us.
+*/
+#define MY_SWITCH_SETTLE           2    /*!< zusaetzliche Wandlungen Ladezeit */
 
 #endif /* MYASURO_H */
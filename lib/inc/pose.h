@@ -0,0 +1,73 @@
+/*!
+  \file pose.h
+  \brief Definitionen und Funktionen fuer die Positionsberechnung (Koppelnavigation).
+
+  \par Positionsberechnung
+  PoseInit() haengt sich mit enchook an die Odometrie im Interrupt SIG_ADC\n
+  und zaehlt dort nur die Ticks. Gerechnet wird im Takt von Timer 0\n
+  (CtrlBackground()) und in GetPose().\n
+  Jeder Tick eines Rades verschiebt die Fahrzeugmitte um einen halben Tick\n
+  in Fahrtrichtung und dreht die Richtung um den Winkel, den ein Rad mit\n
+  einem Tick bei einer Drehung auf der Stelle macht. Tickgroesse und\n
+  Radabstand kommen aus MY_GO_ENC_COUNT_VALUE und MY_TURN_ENC_COUNT_VALUE,\n
+  also aus derselben Kalibrierung wie bei GoTurn().\n
+  Koordinaten: x in Startrichtung, y nach links, Winkel links herum positiv.
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            Rechnung aus dem Interrupt SIG_ADC in den Takt von Timer 0
+ */
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+
+#ifndef POSE_H
+#define POSE_H
+
+/*!
+ * \~english
+ * \brief position and heading of the robot
+ */
+typedef struct
+{
+  int          x;                       /*!< mm in start direction */
+  int          y;                       /*!< mm to the left */
+  unsigned int theta;                   /*!< heading, 65536 = 360 degree, counter clockwise */
+} pose_t;
+
+/*! Winkel aus pose_t.theta in Grad (0..359) */
+#define POSE_DEG(theta) ((int) (((unsigned long) (theta) * 360UL + 32768UL) >> 16) % 360)
+
+/*!
+ * \~english
+ * \brief start the pose integration, pose = 0, 0, 0
+ *        (the odometry and the timer 0 tick are started if necessary)
+ */
+void PoseInit(void);
+/*!
+ * \~english
+ * \brief stop the pose integration
+ */
+void PoseStop(void);
+/*!
+ * \~english
+ * \brief set the current pose
+ * \param x mm
+ * \param y mm
+ * \param theta heading, 65536 = 360 degree
+ */
+void PoseSet(int x, int y, unsigned int theta);
+/*!
+ * \~english
+ * \brief read the current pose without tearing
+ * \param pose destination
+ */
+void GetPose(pose_t *pose);
+
+#endif /* POSE_H */
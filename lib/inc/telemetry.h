@@ -0,0 +1,114 @@
+/*!
+  \file telemetry.h
+  \brief Definitionen und Funktionen fuer die binaere Telemetrie.
+
+  \par Telemetrie statt PrintInt
+  Mit PrintInt() und SerPrint() gehen die meisten der wenigen Bytes/s der\n
+  IR-Schnittstelle fuer Ziffern und Trennzeichen drauf, und ein gestoertes\n
+  Zeichen faellt niemandem auf. Die Telemetrie Funktionen senden die\n
+  Messwerte deshalb binaer in kurzen Rahmen:
+
+  \code
+  +------+-------+-------+---------------+-------+
+  | Typ  | Zeit  | Zeit  | Nutzdaten     | CRC-8 |  --COBS-->  ... 0x00
+  |      | (Low) | (High)| (Little End.) |       |
+  +------+-------+-------+---------------+-------+
+  \endcode
+
+  Zeit sind die unteren 16 Bit von Gettime() in ms. Die CRC-8 ist die\n
+  Dallas/Maxim CRC (_crc_ibutton_update() aus avr-libc) ueber Typ, Zeit und\n
+  Nutzdaten. Der ganze Rahmen wird mit COBS (Consistent Overhead Byte\n
+  Stuffing) kodiert und mit einem 0x00 abgeschlossen. Nach einem Fehler\n
+  findet der Empfaenger so beim naechsten 0x00 wieder den Anfang.\n
+  Ein Encoder-Datensatz braucht so 10 Byte auf der Leitung.
+
+  \par Delta-Streams
+  Fuer periodische Messwerte gibt es zusaetzlich Streams (TLM_STREAM +\n
+  Stream Nummer). Jeder Kanal wird als Differenz zum vorherigen Sample\n
+  gesendet, Zig-Zag kodiert (0, -1, 1, -2 ... -> 0, 1, 2, 3 ...) und als\n
+  Varint mit 7 Bit pro Byte verpackt. Kleine Aenderungen brauchen so nur\n
+  1 Byte pro Kanal. Mehrere Samples teilen sich einen Rahmen. Alle keyint\n
+  Samples beginnt ein neuer Rahmen mit absoluten Werten (Keyframe), damit\n
+  der Empfaenger nach einem verlorenen Rahmen wieder einsteigen kann.\n
+  Nutzdaten eines Stream Rahmens:
+
+  \code
+  | Kopf: Bit7 Keyframe, Bit6..4 Kanaele-1, Bit3..0 Folgenummer | Samples |
+  \endcode
+
+  Die Zeit im Rahmen gehoert zum ersten Sample. Die Zeiten der weiteren\n
+  Samples ergeben sich aus dem Abstand der Rahmen eines Streams (bei\n
+  festem Takt: Rahmenabstand / Samples im vorherigen Rahmen).
+
+  \par Auswertung am PC
+  tools/tlmdecode.c dekodiert den Datenstrom und gibt CSV aus.
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            Delta/Varint Streams TLM_STREAM
+  \version  V003 - 17.10.2026\n
+            TLM_STREAM_CHANNELS 7, damit ein Sample mit Kopf immer in\n
+            TLM_MAX_DATA passt
+  \version  V004 - 17.10.2026\n
+            Zeit eines Stream Rahmens ist die vom ersten Sample, neu\n
+            tlm_stream_t.time
+ */
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+/* Datensatz Typen */
+#define TLM_ENCODER   0x01  /*!< int16 links, int16 rechts (encoder[]) */
+#define TLM_LINE      0x02  /*!< uint16 links, uint16 rechts (LineData) */
+#define TLM_ODOMETRY  0x03  /*!< uint16 links, uint16 rechts (OdometryData) */
+#define TLM_BATTERY   0x04  /*!< uint16 Batterie ADC Wert (Battery) */
+#define TLM_SWITCH    0x05  /*!< uint8 Tasterbits (PollSwitch) */
+#define TLM_STREAM    0x10  /*!< 0x10..0x1F Delta-Streams 0..15 */
+#define TLM_USER      0x40  /*!< ab hier fuer eigene Datensaetze */
+
+#define TLM_MAX_DATA  24    /*!< maximale Nutzdaten pro Rahmen in Byte */
+#define TLM_STREAM_CHANNELS 7 /*!< maximale Kanaele pro Stream */
+
+/* Kopf + schlimmstes Sample (3 Byte pro Kanal) muss in einen Rahmen passen */
+#if 1 + 3 * TLM_STREAM_CHANNELS > TLM_MAX_DATA
+#error "TLM_STREAM_CHANNELS zu gross fuer TLM_MAX_DATA"
+#endif
+
+/*!
+  Zustand eines Delta-Streams. Wird mit TlmStreamInit() vorbelegt.
+*/
+typedef struct
+{
+  unsigned char id;                     /*!< Stream Nummer 0..15 */
+  unsigned char channels;               /*!< Anzahl Kanaele 1..7 */
+  unsigned char keyint;                 /*!< alle keyint Samples Keyframe */
+  unsigned char count;                  /*!< Samples seit dem Keyframe */
+  unsigned char seq;                    /*!< Folgenummer der Rahmen */
+  unsigned char len;                    /*!< belegte Bytes in buf */
+  unsigned int time;                    /*!< Gettime() beim ersten Sample im Rahmen */
+  int16_t last [TLM_STREAM_CHANNELS];   /*!< letztes Sample */
+  unsigned char buf [TLM_MAX_DATA];     /*!< Nutzdaten vom offenen Rahmen */
+} tlm_stream_t;
+
+/* Telemetrie Funktionsprototypen */
+
+void TlmSend(unsigned char type, const void *data, unsigned char length);
+void TlmEncoder(void);
+void TlmLine(const unsigned int *data);
+void TlmOdometry(const unsigned int *data);
+void TlmBattery(int value);
+void TlmSwitch(unsigned char value);
+void TlmStreamInit(tlm_stream_t *s, unsigned char id, unsigned char channels, unsigned char keyint);
+void TlmStreamAdd(tlm_stream_t *s, const int *values);
+void TlmStreamFlush(tlm_stream_t *s);
+
+#endif /* TELEMETRY_H */
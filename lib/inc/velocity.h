@@ -0,0 +1,46 @@
+/*!
+  \file velocity.h
+  \brief Definitionen und Funktionen fuer die Fahrt mit Bahn- und Drehgeschwindigkeit.
+
+  \par Geschwindigkeit in physikalischen Einheiten
+  SetVelocity() nimmt die Geschwindigkeit der Fahrzeugmitte in mm/s und\n
+  die Drehgeschwindigkeit in Grad/s und rechnet daraus die Sollwerte beider\n
+  Raeder fuer die Geschwindigkeitsregelung (ctrl.c). GetVelocity() liefert\n
+  dasselbe Paar aus den gemessenen Radgeschwindigkeiten zurueck.\n
+  Radabstand und Tickgroesse kommen wie bei GoTurn() und pose.c aus\n
+  MY_TURN_ENC_COUNT_VALUE und MY_GO_ENC_COUNT_VALUE. Ein Regler, der mit\n
+  v und Omega arbeitet, laeuft damit auf jedem Asuro, dessen Werte in\n
+  myasuro.h stimmen.\n
+  Drehrichtung wie bei pose_t: links herum positiv.
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+ */
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+
+#ifndef VELOCITY_H
+#define VELOCITY_H
+
+/*!
+ * \~english
+ * \brief drive with a linear and angular velocity (starts CtrlInit if necessary)
+ * \param v speed of the robot centre in mm/s, negative = backward
+ * \param omega turn rate in degree/s, positive = counter clockwise (left)
+ */
+void SetVelocity(int v, int omega);
+/*!
+ * \~english
+ * \brief measured linear and angular velocity from the wheel encoders
+ * \param v speed of the robot centre in mm/s
+ * \param omega turn rate in degree/s, positive = counter clockwise (left)
+ */
+void GetVelocity(int *v, int *omega);
+
+#endif /* VELOCITY_H */
@@ -0,0 +1,922 @@
+/****************************************************************************/
+/*!
+  \file     motion.c
+
+  \brief    Warteschlange fuer Fahrstrecken, Drehungen und Kreisboegen.\n
+            Die Abschnitte werden im Regeltakt der Geschwindigkeitsregelung\n
+            (ctrl.c) abgefahren, das eigene Programm laeuft weiter.
+
+  \see      MOTION_xxx in motion.h\n
+            MY_MOTION_QUEUE, MY_MOTION_ACCEL, MY_MOTION_VMIN, MY_MOTION_KSYNC,\n
+            MY_MOTION_VJUMP, MY_MOTION_BLEND,\n
+            MY_GO_ENC_COUNT_VALUE, MY_TURN_ENC_COUNT_VALUE in myasuro.h
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            +++ MotionAccel()  NEU\n
+            Trapezprofil: Anfahren und Bremsen mit begrenzter Beschleunigung
+  \version  V003 - 17.10.2026\n
+            Gleichlauf haelt das Verhaeltnis der gefahrenen Ticks\n
+            (MY_MOTION_KSYNC), nicht nur das der Geschwindigkeiten
+  \version  V004 - 17.10.2026\n
+            +++ MotionBlend()  NEU\n
+            Vorausschau ueber die Warteschlange: Geschwindigkeit an den\n
+            Uebergaengen (MY_MOTION_VJUMP), Ecken als Kreisbogen
+  \version  V005 - 17.10.2026\n
+            +++ MotionArc()\n
+            Kreisboegen nur vorwaerts, negativer Radius wie positiver
+  \version  V006 - 17.10.2026\n
+            Ist ein Rad am Ziel, faehrt das andere seine letzten Ticks mit\n
+            mindestens MY_MOTION_VMIN. Das innere Rad eines engen Bogens\n
+            blieb sonst unter der Anlauf-PWM stehen.
+  \version  V007 - 17.10.2026\n
+            Trapezprofil folgt beim Bremsen der Bremskurve bis\n
+            MY_MOTION_VMIN, statt kurz vor dem Ziel zwischen Bremsen und\n
+            Beschleunigen zu pendeln
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "asuro.h"
+#include "myasuro.h"
+#include "ctrl.h"
+#include "motion.h"
+#include "fixmath.h"
+
+typedef struct
+{
+  unsigned char type;                   // MOTION_GO, MOTION_TURN, MOTION_ARC
+  unsigned char id;
+  int           value;                  // Strecke in mm oder Winkel in Grad
+  int           radius;                 // nur MOTION_ARC
+  int           speed;                  // Hoechstgeschwindigkeit mm/s
+  int           vend;                   // Geschwindigkeit am Ende mm/s
+  int           ratio [2];              // goal / big * 256 je Rad
+  int           len;                    // Weg des Rades mit dem laengeren Weg mm
+} segment_t;
+
+/*
+  Halber Radabstand in mm: eine Drehung auf der Stelle sind
+  MY_TURN_ENC_COUNT_VALUE Ticks = Pi * Radabstand
+*/
+#define MOTION_HALFTRACK  ((int) ((MY_TURN_ENC_COUNT_VALUE * MY_GO_ENC_COUNT_VALUE) / 62832L))
+
+static segment_t     queue [MY_MOTION_QUEUE];
+static volatile unsigned char head, count;
+static unsigned char lastid;
+static volatile unsigned char running;  // Abschnitt queue[head] laeuft
+static long          start [2];         // enctick beim Start des Abschnitts
+static long          goal [2];          // zu fahrende Ticks mit Vorzeichen
+static int           wheel [2];         // Sollwerte fuer CtrlSpeed() in mm/s
+static unsigned char active [2];        // Rad noch nicht am Ziel
+static long          big;               // Ticks des Rades mit dem laengeren Weg
+static long          dist;              // Ticks beider Raeder zusammen
+static int           vmax, vend;        // aus dem laufenden Abschnitt
+static long          profv;             // Profilgeschwindigkeit mm/s * 256
+static volatile int  accel = MY_MOTION_ACCEL;
+static volatile int  blend = MY_MOTION_BLEND;   // Eckenradius mm, 0 = aus
+static void (* volatile callback) (unsigned char id);
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Berechnet die Ziel-Ticks beider Raeder fuer einen Abschnitt.
+
+  \param[in]
+  seg Abschnitt
+  \param[out]
+  g Ticks links und rechts mit Vorzeichen
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Die Umrechnung entspricht GoTurn(): 10000 / MY_GO_ENC_COUNT_VALUE Ticks\n
+  je mm, MY_TURN_ENC_COUNT_VALUE Ticks je Rad fuer eine ganze Drehung auf\n
+  der Stelle. Beim Kreisbogen faehrt die Mitte den Bogen R * Winkel, die\n
+  Raeder zusaetzlich +- die Ticks einer Drehung um denselben Winkel.
+*****************************************************************************/
+static void MotionGoal (
+  segment_t *seg,
+  long *g)
+{
+  long turn, mm;
+
+  switch (seg->type)
+  {
+    case MOTION_GO:
+      g [LEFT] = ((long) seg->value * 10000L) / MY_GO_ENC_COUNT_VALUE;
+      g [RIGHT] = g [LEFT];
+      break;
+    case MOTION_TURN:
+      g [LEFT]  = ((long) seg->value * MY_TURN_ENC_COUNT_VALUE) / 360L;
+      g [RIGHT] = -g [LEFT];
+      break;
+    default:
+      turn = ((long) seg->value * MY_TURN_ENC_COUNT_VALUE) / 360L;
+      mm   = ((long) abs (seg->value) * abs (seg->radius) * 100L) / 5730L; // R * Bogenmass
+      mm   = (mm * 10000L) / MY_GO_ENC_COUNT_VALUE;
+      g [LEFT]  = mm + turn;            // Winkel > 0: rechts herum
+      g [RIGHT] = mm - turn;
+      break;
+  }
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Traegt Radverhaeltnis und Weglaenge eines Abschnitts fuer die\n
+  Vorausschau (MotionPlan()) ein.
+
+  \param[in,out]
+  seg Abschnitt
+
+  \return
+  nichts
+*****************************************************************************/
+static void MotionShape (
+  segment_t *seg)
+{
+  long          g [2], b;
+  unsigned char side;
+
+  MotionGoal (seg, g);
+  b = labs (g [LEFT]);
+  if (labs (g [RIGHT]) > b)
+    b = labs (g [RIGHT]);
+  for (side = LEFT; side <= RIGHT; side++)
+    seg->ratio [side] = b ? (int) ((g [side] * 256L) / b) : 0;
+  seg->len = (int) ((b * MY_GO_ENC_COUNT_VALUE) / 10000L);
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Berechnet Ziel-Ticks und Radgeschwindigkeiten fuer einen Abschnitt.
+
+  \param[in]
+  seg Abschnitt aus der Warteschlange
+
+  \return
+  nichts
+*****************************************************************************/
+static void MotionLoad (
+  segment_t *seg)
+{
+  unsigned char side, sreg;
+
+  MotionGoal (seg, goal);
+
+  big = labs (goal [LEFT]);
+  if (labs (goal [RIGHT]) > big)
+    big = labs (goal [RIGHT]);
+  dist = labs (goal [LEFT]) + labs (goal [RIGHT]);
+  vmax = seg->speed;
+  vend = seg->vend;
+  if (accel == 0)
+    profv = (long) vmax << 8;           // ohne Profil: sofort volle Fahrt
+  for (side = LEFT; side <= RIGHT; side++)
+  {
+    active [side] = (goal [side] != 0);
+    sreg = SREG;
+    cli ();
+    start [side] = enctick [side];
+    SREG = sreg;
+  }
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Rueckruffunktion fuer den Regeltakt (CtrlHook()). Arbeitet die\n
+  Warteschlange ab.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Die Geschwindigkeit folgt einem Trapezprofil (Anfahren mit MotionAccel(),\n
+  Fahrt mit der Hoechstgeschwindigkeit, Bremsen bis MY_MOTION_VMIN). Die\n
+  Raeder bekommen sie im Verhaeltnis ihrer Ticks, damit beide gleichzeitig\n
+  ankommen. Weicht das Verhaeltnis der bisher gefahrenen Ticks davon ab\n
+  (ein Rad eilt vor), wird das vorauseilende Rad um MY_MOTION_KSYNC mm/s\n
+  je Tick Abweichung langsamer und das andere schneller. So bleibt der\n
+  Radius eines Bogens und die Richtung einer Geraden auch dann erhalten,\n
+  wenn ein Rad nach dem Anfahren oder an einer Teppichkante hinterher\n
+  haengt. Jedes Rad haelt an, sobald es seine Ticks gefahren hat. Das\n
+  andere faehrt seinen Rest dann mit mindestens MY_MOTION_VMIN (das\n
+  innere Rad eines engen Bogens bekaeme sonst nur wenige mm/s).\n
+  Sind beide Raeder am Ziel, ist der Abschnitt fertig und der naechste\n
+  startet noch im selben Takt mit der erreichten Geschwindigkeit.\n
+  Ist die Warteschlange leer, werden die Sollwerte nicht angefasst,\n
+  CtrlSpeed() kann dann direkt benutzt werden.
+*****************************************************************************/
+static void MotionTick (
+  void)
+{
+  unsigned char side, id, sreg;
+  long          pos [2], done, rem, v, vlow, dv, sync, corr;
+
+  if (!running && !count)
+    return;                             // CtrlSpeed() gehoert dem Programm
+
+  while (1)
+  {
+    if (!running)
+    {
+      if (!count)
+      {
+        profv = 0;                      // alles abgefahren
+        wheel [LEFT] = wheel [RIGHT] = 0;
+        CtrlSpeed (0, 0);
+        return;
+      }
+      MotionLoad (&queue [head]);
+      running = TRUE;
+    }
+
+    done = 0;
+    for (side = LEFT; side <= RIGHT; side++)
+    {
+      sreg = SREG;
+      cli ();
+      pos [side] = enctick [side] - start [side];
+      SREG = sreg;
+      if ((goal [side] >= 0 && pos [side] >= goal [side]) ||
+          (goal [side] <  0 && pos [side] <= goal [side]))
+        active [side] = FALSE;
+      done += active [side] ? labs (pos [side]) : labs (goal [side]);
+    }
+    if (active [LEFT] || active [RIGHT])
+      break;
+
+    id = queue [head].id;               // Abschnitt fertig
+    head = (head + 1) % MY_MOTION_QUEUE;
+    count --;
+    running = FALSE;
+    if (callback)
+      callback (id);
+  }
+
+  /*
+    Trapezprofil fuer das Rad mit dem laengeren Weg: hoechstens vmax und
+    hoechstens so schnell, dass bis zum Ende noch auf vlow gebremst werden
+    kann (v^2 = vlow^2 + 2 * a * Reststrecke), je Takt um hoechstens dv
+    schneller oder langsamer. Die Reststrecke kommt aus den Ticks beider
+    Raeder (mm). Das Rad kann schon fast einen Tick weiter sein und faehrt
+    bis zum naechsten Takt noch v / CTRL_HZ, beides wird abgezogen. So ist
+    das Profil vor dem letzten Tick bei vlow.
+  */
+  if (accel)
+  {
+    v    = profv >> 8;
+    dv   = ((long) accel << 8) / CTRL_HZ;
+    vlow = (vend > MY_MOTION_VMIN) ? vend : MY_MOTION_VMIN;
+    if (vlow > vmax)
+      vlow = vmax;
+    rem  = ((dist - done) * MY_GO_ENC_COUNT_VALUE / 10000L) * big / dist;
+    rem -= (MY_GO_ENC_COUNT_VALUE + 9999L) / 10000L + v / CTRL_HZ;
+    if (rem < 0)
+      rem = 0;
+    v = (long) ISqrt ((unsigned long) vlow * vlow + 2UL * accel * rem) << 8;
+    if (v > ((long) vmax << 8))
+      v = (long) vmax << 8;
+    if (v > profv + dv)
+      v = profv + dv;
+    else if (v < profv - dv)
+      v = profv - dv;
+    profv = v;
+  }
+
+  /*
+    Gleichlauf: Soll ist |pos| : |goal| gleich fuer beide Raeder. sync ist
+    die Abweichung in Ticks (> 0: links voraus), fuer das rechte Rad gilt
+    sie mit umgekehrtem Vorzeichen. Die Korrektur ist auf vmax / 4
+    begrenzt und dreht ein Rad nie um.
+  */
+  sync = 0;
+  if (active [LEFT] && active [RIGHT])
+    sync = (labs (pos [LEFT]) * labs (goal [RIGHT]) -
+            labs (pos [RIGHT]) * labs (goal [LEFT])) / dist;
+  corr = sync * MY_MOTION_KSYNC;
+  if (corr > (vmax >> 2))
+    corr = vmax >> 2;
+  else if (corr < -(vmax >> 2))
+    corr = -(vmax >> 2);
+
+  for (side = LEFT; side <= RIGHT; side++)
+  {
+    if (!active [side])
+    {
+      wheel [side] = 0;
+      continue;
+    }
+    v = (profv * goal [side] / big) >> 8;
+    dv = (side == LEFT) ? -corr : corr;
+    if (goal [side] > 0)
+      v = (v + dv > 0) ? v + dv : 0;
+    else
+      v = (v - dv < 0) ? v - dv : 0;
+    if (!active [(side == LEFT) ? RIGHT : LEFT] && labs (v) < MY_MOTION_VMIN)
+      v = (goal [side] > 0) ? MY_MOTION_VMIN : -MY_MOTION_VMIN;
+    wheel [side] = (int) v;
+  }
+  CtrlSpeed (wheel [LEFT], wheel [RIGHT]);
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Hoechste Geschwindigkeit am Uebergang zwischen zwei Abschnitten.
+
+  \param[in]
+  a Abschnitt davor
+  \param[in]
+  b Abschnitt danach
+
+  \return
+  Geschwindigkeit in mm/s (Rad mit dem laengeren Weg)
+
+  \par  Funktionsweise:
+  Am Uebergang springt jedes Rad von v * ratio_a auf v * ratio_b. Der\n
+  Sprung darf MY_MOTION_VJUMP nicht ueberschreiten. Dreht ein Rad am\n
+  Uebergang um (z.B. Gerade -> Drehung auf der Stelle), wird angehalten.
+*****************************************************************************/
+static int MotionJunction (
+  segment_t *a,
+  segment_t *b)
+{
+  int           v, d, dmax = 0;
+  long          lim;
+  unsigned char side;
+
+  v = (a->speed < b->speed) ? a->speed : b->speed;
+  for (side = LEFT; side <= RIGHT; side++)
+  {
+    if ((a->ratio [side] > 0 && b->ratio [side] < 0) ||
+        (a->ratio [side] < 0 && b->ratio [side] > 0))
+      return 0;
+    d = abs (a->ratio [side] - b->ratio [side]);
+    if (d > dmax)
+      dmax = d;
+  }
+  if (dmax)
+  {
+    lim = ((long) MY_MOTION_VJUMP << 8) / dmax;
+    if (lim < v)
+      v = (int) lim;
+  }
+  return v;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Vorausschau: setzt die Endgeschwindigkeit vend aller Abschnitte in der\n
+  Warteschlange.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Rueckwaerts vom letzten Abschnitt (vend = 0): ein Uebergang darf nur so\n
+  schnell sein, wie der folgende Abschnitt bis zu seinem eigenen vend\n
+  noch bremsen kann (v^2 = vend^2 + 2 * a * Laenge), und hoechstens\n
+  MotionJunction(). Abschnitte ohne Weg (z.B. eine Gerade, die zwischen\n
+  zwei abgerundeten Ecken ganz weggefallen ist) werden dabei\n
+  durchgereicht. Gerechnet wird ohne cli() auf den Abschnitten, nur\n
+  das Eintragen ist gesperrt. Haengt die Rueckruffunktion waehrenddessen\n
+  etwas an, bleibt dessen Uebergang vorerst bei 0 (langsamer, aber\n
+  sicher) bis zum naechsten Aufruf.
+*****************************************************************************/
+static void MotionPlan (
+  void)
+{
+  int           v [MY_MOTION_QUEUE];
+  int           vnext = 0, vj;
+  unsigned char n, first, i, sreg;
+  unsigned long reach;
+  segment_t    *a, *b, *nb;
+
+  sreg = SREG;
+  cli ();
+  n     = count;
+  first = head;
+  SREG = sreg;
+  if (n == 0 || accel == 0)
+    return;
+
+  v [n - 1] = 0;
+  nb = &queue [(first + n - 1) % MY_MOTION_QUEUE];
+  for (i = n - 1; i > 0; i--)
+  {
+    a = &queue [(first + i - 1) % MY_MOTION_QUEUE];
+    b = &queue [(first + i) % MY_MOTION_QUEUE];
+    if (b->len > 0)
+      nb = b;                           // sonst durchreichen
+    reach = ISqrt ((unsigned long) vnext * vnext +
+                   2UL * accel * b->len);
+    vj = (a->len > 0) ? MotionJunction (a, nb) : a->speed;
+    if ((unsigned long) vj > reach)
+      vj = (int) reach;
+    v [i - 1] = vj;
+    vnext = vj;
+  }
+
+  sreg = SREG;
+  cli ();
+  for (i = 0; i < n; i++)
+    queue [(first + i) % MY_MOTION_QUEUE].vend = v [i];
+  if (running)
+    vend = queue [head].vend;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Rundet die Ecke Gerade - Drehung - Gerade am Ende der Warteschlange mit\n
+  einem Kreisbogen ab (MotionBlend()).
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Bogen mit Radius r um den Winkel der Drehung, beide Geraden werden um\n
+  d = r * tan (Winkel / 2) gekuerzt. Laeuft die erste Gerade schon, werden\n
+  auch ihre Ziel-Ticks gekuerzt, sofern noch genug Weg uebrig ist.\n
+  Radien bis zum halben Radabstand bringen nichts (das innere Rad\n
+  stuende oder drehte rueckwaerts), dann bleibt die Drehung auf der Stelle.
+*****************************************************************************/
+static void MotionCorner (
+  void)
+{
+  segment_t    *go1, *turn, *go2;
+  segment_t     arc;
+  unsigned char n, h, sreg, ok;
+  unsigned int  half;
+  int           deg, len, r, d, sn, cs, v;
+  long          dl, dt;
+
+  sreg = SREG;
+  cli ();
+  n = count;
+  h = head;
+  SREG = sreg;
+  if (n < 3)
+    return;
+  go2  = &queue [(h + n - 1) % MY_MOTION_QUEUE];
+  turn = &queue [(h + n - 2) % MY_MOTION_QUEUE];
+  go1  = &queue [(h + n - 3) % MY_MOTION_QUEUE];
+  if (go1->type != MOTION_GO || turn->type != MOTION_TURN ||
+      go1->value <= 0 || go2->value <= 0 ||
+      turn->value == 0 || abs (turn->value) >= 180)
+    return;
+
+  /* d = r * tan (Winkel / 2), r verkleinern, wenn eine Gerade zu kurz ist */
+  deg  = turn->value;
+  half = FIX_ANGLE (abs (deg)) / 2;
+  sn   = FixSin (half);
+  cs   = FixCos (half);
+  len  = (go1->value < go2->value) ? go1->value : go2->value;
+  r    = blend;
+  dl   = ((long) r * sn) / cs;
+  if (dl > len)
+  {
+    dl = len;
+    r  = (int) ((dl * cs) / sn);
+  }
+  d = (int) dl;
+  if (r <= MOTION_HALFTRACK)
+    return;
+  dt = ((long) d * 10000L) / MY_GO_ENC_COUNT_VALUE;
+
+  v = (go1->speed < go2->speed) ? go1->speed : go2->speed;
+  if (turn->speed < v)
+    v = turn->speed;
+  arc.type   = MOTION_ARC;
+  arc.value  = deg;
+  arc.radius = r;
+  arc.speed  = v;
+  MotionShape (&arc);
+
+  sreg = SREG;
+  cli ();
+  ok = (head == h && count >= n);
+  if (ok && running && go1 == &queue [head])
+  {                                     // erste Gerade laeuft schon
+    ok = (goal [LEFT]  - (enctick [LEFT]  - start [LEFT])  > dt + 2 &&
+          goal [RIGHT] - (enctick [RIGHT] - start [RIGHT]) > dt + 2);
+    if (ok)
+    {
+      goal [LEFT]  -= dt;
+      goal [RIGHT] -= dt;
+      big  -= dt;
+      dist -= 2 * dt;
+    }
+  }
+  if (ok)
+  {
+    go1->value -= d;
+    go1->len    = (go1->value && go1->len > d) ? go1->len - d : 0;
+    go2->value -= d;
+    go2->len    = (go2->value && go2->len > d) ? go2->len - d : 0;
+    turn->type   = MOTION_ARC;
+    turn->radius = r;
+    turn->speed  = v;
+    turn->ratio [LEFT]  = arc.ratio [LEFT];
+    turn->ratio [RIGHT] = arc.ratio [RIGHT];
+    turn->len    = arc.len;
+  }
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Haengt einen Abschnitt an die Warteschlange an.
+
+  \return
+  Kennung des Abschnitts 1..255, 0 = Warteschlange voll
+*****************************************************************************/
+static unsigned char MotionAdd (
+  unsigned char type,
+  int value,
+  int radius,
+  int speed)
+{
+  segment_t    *seg;
+  unsigned char id = 0;
+  unsigned char sreg;
+  segment_t     s;
+
+  MotionInit ();
+
+  s.type   = type;
+  s.value  = value;
+  s.radius = radius;
+  s.speed  = abs (speed);
+  s.vend   = 0;
+  MotionShape (&s);                     // Divisionen ausserhalb von cli()
+
+  sreg = SREG;
+  cli ();                               // auch aus der Rueckruffunktion
+  if (count < MY_MOTION_QUEUE)
+  {
+    if (++lastid == 0)
+      lastid = 1;
+    id  = lastid;
+    s.id = id;
+    seg = &queue [(head + count) % MY_MOTION_QUEUE];
+    *seg = s;
+    count ++;
+  }
+  SREG = sreg;
+
+  if (id)
+  {
+    if (type == MOTION_GO && blend)
+      MotionCorner ();
+    MotionPlan ();
+  }
+  return id;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Startet die Geschwindigkeitsregelung und haengt die Warteschlange an\n
+  den Regeltakt.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Muss nicht aufgerufen werden, die anderen Motion-Funktionen machen das\n
+  selbst. Nach CtrlStop() wird die Warteschlange erst mit dem naechsten\n
+  Aufruf wieder abgearbeitet.
+*****************************************************************************/
+void MotionInit (
+  void)
+{
+  if (!CtrlActive ())
+    CtrlInit ();
+  CtrlHook (MotionTick);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Haengt eine gerade Fahrstrecke an die Warteschlange an.
+
+  \param[in]
+  distance Strecke in mm (- rueckwaerts, + vorwaerts)
+  \param[in]
+  speed Geschwindigkeit in mm/s
+
+  \return
+  Kennung des Abschnitts 1..255, 0 = Warteschlange voll
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Quadrat mit 200 mm Kantenlaenge, ohne zu warten
+  for (i = 0; i < 4; i++)
+  {
+    MotionGo (200, 200);
+    MotionTurn (90, 150);
+  }
+  while (MotionBusy ())
+  {
+    if (PollSwitch ())
+      MotionCancel ();                  // Notaus ueber die Taster
+  }
+  \endcode
+*****************************************************************************/
+unsigned char MotionGo (
+  int distance,
+  int speed)
+{
+  return MotionAdd (MOTION_GO, distance, 0, speed);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Haengt eine Drehung auf der Stelle an die Warteschlange an.
+
+  \param[in]
+  degree Winkel (+ rechts herum, - links herum)
+  \param[in]
+  speed Radgeschwindigkeit in mm/s
+
+  \return
+  Kennung des Abschnitts 1..255, 0 = Warteschlange voll
+
+  \par  Beispiel:
+  (siehe unter MotionGo)
+*****************************************************************************/
+unsigned char MotionTurn (
+  int degree,
+  int speed)
+{
+  return MotionAdd (MOTION_TURN, degree, 0, speed);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Haengt einen Kreisbogen vorwaerts an die Warteschlange an.
+
+  \param[in]
+  radius Radius der Fahrzeugmitte in mm (das Vorzeichen wird ignoriert)
+  \param[in]
+  degree Winkel (+ rechts herum, - links herum)
+  \param[in]
+  speed Geschwindigkeit des aeusseren Rades in mm/s
+
+  \return
+  Kennung des Abschnitts 1..255, 0 = Warteschlange voll
+
+  \par  Hinweis:
+  Boegen fahren immer vorwaerts, die Richtung der Kurve kommt nur aus\n
+  degree. Ein negativer Radius wird wie ein positiver gefahren.\n
+  Ist der Radius kleiner als der halbe Radabstand, dreht sich das innere\n
+  Rad rueckwaerts. Radius 0 entspricht MotionTurn().
+*****************************************************************************/
+unsigned char MotionArc (
+  int radius,
+  int degree,
+  int speed)
+{
+  return MotionAdd (MOTION_ARC, degree, radius, speed);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert die Anzahl der offenen Abschnitte.
+
+  \param
+  keine
+
+  \return
+  Anzahl einschliesslich des laufenden Abschnitts, 0 = fertig
+*****************************************************************************/
+unsigned char MotionBusy (
+  void)
+{
+  return count;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Wartet, bis alle Abschnitte abgefahren sind.
+
+  \param
+  keine
+
+  \return
+  nichts
+*****************************************************************************/
+void MotionWait (
+  void)
+{
+  while (count)
+    ;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Verwirft alle Abschnitte und haelt die Raeder an.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Fuer verworfene Abschnitte wird die Rueckruffunktion nicht aufgerufen.
+*****************************************************************************/
+void MotionCancel (
+  void)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  count   = 0;
+  running = FALSE;
+  profv   = 0;
+  wheel [LEFT] = wheel [RIGHT] = 0;
+  CtrlSpeed (0, 0);
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Traegt eine Funktion ein, die nach jedem fertigen Abschnitt mit dessen\n
+  Kennung aufgerufen wird.
+
+  \param[in]
+  fn Rueckruffunktion, NULL = keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Die Funktion laeuft im Regeltakt (Interrupt) und muss kurz sein.\n
+  Sie darf weitere Abschnitte mit MotionGo() usw. anhaengen.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  void Fertig (unsigned char id)
+  {
+    StatusLED (id & 1 ? GREEN : RED);
+  }
+  ...
+  MotionCallback (Fertig);
+  \endcode
+*****************************************************************************/
+void MotionCallback (
+  void (*fn) (unsigned char id))
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  callback = fn;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Legt die Beschleunigung fuer das Anfahren und Bremsen fest.
+
+  \param[in]
+  a Beschleunigung in mm/s^2, 0 = ohne Profil (sofort volle Fahrt)
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Voreinstellung ist MY_MOTION_ACCEL aus myasuro.h. Kleinere Werte\n
+  verringern Schlupf und Stromspitzen, verlaengern aber die Fahrt.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  MotionAccel (400);                    // vorsichtig auf glattem Boden
+  MotionGo (500, 300);
+  \endcode
+*****************************************************************************/
+void MotionAccel (
+  int a)
+{
+  accel = abs (a);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Legt fest, ob Ecken aus Gerade, Drehung und Gerade als Kreisbogen\n
+  durchfahren werden.
+
+  \param[in]
+  radius groesster Radius des Bogens in mm, 0 = an jeder Ecke anhalten\n
+         und auf der Stelle drehen
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Voreinstellung ist MY_MOTION_BLEND aus myasuro.h (0).\n
+  Wird eine Gerade angehaengt, waehrend davor schon Gerade und Drehung\n
+  in der Warteschlange stehen, wird die Drehung durch einen Bogen um\n
+  denselben Winkel ersetzt und beide Geraden werden um\n
+  radius * tan (Winkel / 2) gekuerzt. Richtung und Position am Ende der\n
+  zweiten Geraden bleiben gleich, nur die Ecke wird abgerundet: bei 90\n
+  Grad laeuft die Bahn um 0.41 * radius innen an der Ecke vorbei.\n
+  Sind die Geraden zu kurz, wird der Radius verkleinert. Rueckwaerts,\n
+  bei Drehungen ab 180 Grad und bei Radien bis zum halben Radabstand\n
+  (ca. 55 mm) wird nicht abgerundet.\n
+  Die Ecke muss in der Warteschlange stehen, bevor der Asuro sie\n
+  erreicht: erst alle Abschnitte anhaengen, dann MotionWait(). Mit\n
+  GoTurn() (wartet nach jedem Abschnitt) gibt es nichts abzurunden.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Quadrat ohne Halt an den Ecken
+  MotionBlend (100);
+  for (i = 0; i < 4; i++)
+  {
+    MotionGo (200, 200);
+    MotionTurn (90, 200);
+  }
+  MotionWait ();                        // letzte Drehung auf der Stelle
+  \endcode
+*****************************************************************************/
+void MotionBlend (
+  int radius)
+{
+  blend = abs (radius);
+}
@@ -28,6 +28,16 @@
             Kommentierte Version (KEINE Funktionsaenderung)
   \version  V003 - 18.02.2007 - m.a.r.v.i.n\n
             Datei gesplitted in motor_low.c und motor.c 
+  \version  V004 - 17.10.2026\n
+            +++ MotorCalibrate(), MotorLinSet()  NEU\n
+            Kennlinie der Motoren aus der Odometrie
+  \version  V005 - 17.10.2026\n
+            +++ SetMotorPower16()  NEU\n
+            MotorCalibrate() auch mit MotorPwmMode() != MOTOR_PWM_8BIT
+  \version  V006 - 17.10.2026\n
+            MotorCalibrate() schaltet die Rampe (MotorSlew()) solange ab
+  \version  V007 - 17.10.2026\n
+            MotorCalibrate() misst die Anlauf-PWM aus dem Stand
 	    
 *****************************************************************************/
 /*****************************************************************************
@@ -39,6 +49,24 @@
 *                                                                            *
 *****************************************************************************/
 #include "asuro.h"
+#include "myasuro.h"
+#include "ctrl.h"
+
+/*
+  PWM der Messpunkte fuer MotorCalibrate(): 0, 16 .. 240, 255
+*/
+#define MOTOR_CAL_PWM(k)  ((k) < 16 ? (k) * 16 : 255)
+#define MOTOR_CAL_VSTOP   10            // darunter steht das Rad (mm/s)
+#define MOTOR_CAL_VMIN    50            // kleinste brauchbare motorvmax
+#define MOTOR_CAL_BSTEP   4             // PWM-Schritt beim Anlaufen aus dem Stand
+#define MOTOR_CAL_BTIME   40            // ms je Schritt
+#define MOTOR_CAL_BTICKS  2             // ab so vielen Ticks dreht das Rad
+
+/*
+  Waehrend der Messung direkt auf die PWM, vorbei an MY_MOTOR_DIFF und
+  pwmlimit in MotorSpeed()
+*/
+#define MOTOR_CAL_OCR(pwm)  (OCR1A = OCR1B = MotorPwmOcr ((pwm) * 257U))
 
 
 
@@ -123,3 +151,403 @@ void SetMotorPower (
   */
   MotorSpeed (leftpwm * 2, rightpwm * 2);
 }
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Steuert die Motorgeschwindigkeit \b und Drehrichtung der Motoren mit\n
+  16 Bit Aufloesung.
+
+  \param[in]
+  leftpwm   linker Motor (-rueckwaerts, + vorwaerts) (Wertebereich -32767...32767)
+  \param[in]
+  rightpwm  rechter Motor (-rueckwaerts, + vorwaerts) (Wertebereich -32767...32767)
+
+  \return
+  nichts
+
+  \see
+  MotorSpeed16(), MotorPwmMode()
+
+  \par  Hinweis:
+  Wie SetMotorPower(), die Betraege werden mit 2 multipliziert an\n
+  MotorSpeed16() weitergegeben. Anders als bei SetMotorPower() geht dabei\n
+  keine Stufe der PWM verloren.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  MotorPwmMode (MOTOR_PWM_20KHZ);
+  SetMotorPower16 (6000, 6100);         // langsam, rechts etwas staerker
+  \endcode
+*****************************************************************************/
+void SetMotorPower16 (
+  int leftpwm,
+  int rightpwm)
+{
+  unsigned char left, right;
+  unsigned int  l, r;
+
+  if (leftpwm < 0)
+  {
+    left = RWD;
+    l = (leftpwm < -32767) ? 32767 : -leftpwm;
+  }
+  else
+  {
+    left = FWD;
+    l = leftpwm;
+  }
+  if (l == 0)
+    left = BREAK;
+
+  if (rightpwm < 0)
+  {
+    right = RWD;
+    r = (rightpwm < -32767) ? 32767 : -rightpwm;
+  }
+  else
+  {
+    right = FWD;
+    r = rightpwm;
+  }
+  if (r == 0)
+    right = BREAK;
+
+  MotorDir (left, right);
+  MotorSpeed16 (l * 2 + (l >> 14), r * 2 + (r >> 14));   // 32767 -> 65535
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Laesst beide Motoren einschwingen und misst die Geschwindigkeit.
+
+  \param[out]
+  v Geschwindigkeit links und rechts in mm/s
+
+  \return
+  nichts
+*****************************************************************************/
+static void MotorCalMeasure (
+  int *v)
+{
+  unsigned char i, n;
+  long          sum [2] = {0, 0};
+
+  for (i = 0; i < MY_MOTOR_CAL_SETTLE / 8; i++)
+  {
+    Msleep (8);
+    EncoderSpeedUpdate ();
+  }
+  for (n = 0; n < MY_MOTOR_CAL_MEASURE / 8; n++)
+  {
+    Msleep (8);
+    EncoderSpeedUpdate ();
+    sum [LEFT]  += EncoderSpeedMm (LEFT);
+    sum [RIGHT] += EncoderSpeedMm (RIGHT);
+  }
+  v [LEFT]  = (int) (sum [LEFT] / n);
+  v [RIGHT] = (int) (sum [RIGHT] / n);
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Faehrt die PWM beider Motoren aus dem Stand langsam hoch und merkt sich,\n
+  ab welcher PWM jedes Rad anlaeuft (Haftreibung).
+
+  \param[out]
+  p Anlauf-PWM links und rechts, 255 wenn das Rad stehen bleibt
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Alle MOTOR_CAL_BTIME ms MOTOR_CAL_BSTEP PWM mehr. Sobald ein Rad\n
+  MOTOR_CAL_BTICKS Ticks gemacht hat, wird sein Motor abgeschaltet.
+*****************************************************************************/
+static void MotorCalBreakaway (
+  unsigned char *p)
+{
+  encoder_snapshot_t snap;
+  long          d [2], n [2] = {0, 0};
+  unsigned int  pwm;
+  unsigned char side, run = 0;
+
+  p [LEFT] = p [RIGHT] = 255;
+  EncoderSnapshot (&snap);
+  for (pwm = MOTOR_CAL_BSTEP; pwm <= 255 && run != 3; pwm += MOTOR_CAL_BSTEP)
+  {
+    OCR1A = (run & (1 << LEFT))  ? 0 : MotorPwmOcr (pwm * 257U);
+    OCR1B = (run & (1 << RIGHT)) ? 0 : MotorPwmOcr (pwm * 257U);
+    Msleep (MOTOR_CAL_BTIME);
+    EncoderDelta (&snap, d);
+    for (side = LEFT; side <= RIGHT; side++)
+    {
+      n [side] += d [side];
+      if (!(run & (1 << side)) && n [side] >= MOTOR_CAL_BTICKS)
+      {
+        p [side] = pwm;
+        run |= 1 << side;
+      }
+    }
+  }
+  MOTOR_CAL_OCR (0);
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Berechnet die Kennlinie eines Motors aus den Messpunkten.
+
+  \param[out]
+  tab Kennlinie, MOTOR_LIN_POINTS Werte
+  \param[in]
+  v Geschwindigkeit in mm/s bei MOTOR_CAL_PWM (0..16)
+  \param[in]
+  vmax Geschwindigkeit fuer die Vorgabe 256
+  \param[in]
+  start Anlauf-PWM aus dem Stand (MotorCalBreakaway())
+
+  \return
+  FALSE, wenn sich das Rad nicht gedreht hat
+
+  \par  Funktionsweise:
+  Die Messpunkte werden zuerst monoton gemacht. Der Schnittpunkt der\n
+  Geraden durch die ersten beiden Punkte mit v > 0 mit der PWM-Achse ist\n
+  die PWM, bei der das laufende Rad stehen bleibt. Von dort wird fuer\n
+  jede Stuetzstelle i die PWM gesucht, die vmax * i / 16 ergibt (lineare\n
+  Interpolation zwischen den Messpunkten).\n
+  tab [0] ist die groessere von Anlauf- und Stopp-PWM, damit das Rad\n
+  auch aus dem Stand anlaeuft. Stuetzstellen darunter werden auf tab [0]\n
+  angehoben.
+*****************************************************************************/
+static unsigned char MotorCalTable (
+  unsigned char *tab,
+  int *v,
+  unsigned int vmax,
+  unsigned char start)
+{
+  unsigned char i, k, k1;
+  int           p0, pa, pb, va, vb, vt;
+
+  for (k = 0; k < MOTOR_LIN_POINTS; k++)
+  {
+    if (v [k] < MOTOR_CAL_VSTOP)
+      v [k] = 0;
+    if (k && v [k] < v [k - 1])
+      v [k] = v [k - 1];
+  }
+  for (k1 = 1; k1 < MOTOR_LIN_POINTS && v [k1] == 0; k1++)
+    ;
+  if (k1 >= MOTOR_LIN_POINTS)
+    return FALSE;
+
+  p0 = MOTOR_CAL_PWM (k1 - 1);
+  if (k1 < MOTOR_LIN_POINTS - 1 && v [k1 + 1] > v [k1])
+  {
+    pa = MOTOR_CAL_PWM (k1);
+    pb = MOTOR_CAL_PWM (k1 + 1);
+    p0 = pa - (int) (((long) v [k1] * (pb - pa)) / (v [k1 + 1] - v [k1]));
+    if (p0 < MOTOR_CAL_PWM (k1 - 1))
+      p0 = MOTOR_CAL_PWM (k1 - 1);
+  }
+  tab [0] = (start > p0) ? start : p0;
+
+  k = k1;
+  for (i = 1; i < MOTOR_LIN_POINTS; i++)
+  {
+    vt = (int) (((long) vmax * i) / 16);
+    while (k < MOTOR_LIN_POINTS && v [k] < vt)
+      k++;
+    if (k >= MOTOR_LIN_POINTS)
+      pa = 255;
+    else
+    {
+      if (k == k1)
+      {
+        pa = p0;
+        va = 0;
+      }
+      else
+      {
+        pa = MOTOR_CAL_PWM (k - 1);
+        va = v [k - 1];
+      }
+      pb = MOTOR_CAL_PWM (k);
+      vb = v [k];
+      if (vb > va)
+        pa += (int) (((long) (pb - pa) * (vt - va) + ((vb - va) >> 1)) / (vb - va));
+      else
+        pa = pb;
+    }
+    if (pa < tab [i - 1])
+      pa = tab [i - 1];
+    tab [i] = (pa > 255) ? 255 : pa;
+  }
+  return TRUE;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Misst die Kennlinie beider Motoren mit der Odometrie und schaltet die\n
+  Umrechnung in MotorSpeed() ein.
+
+  \param
+  keine
+
+  \return
+  Geschwindigkeit in mm/s bei voller Vorgabe (schwaecherer Motor mit\n
+  PWM 255). 0, wenn die Messung fehlgeschlagen ist, z.B. weil keine\n
+  Odometrie-Ticks kommen. Die Umrechnung bleibt dann ausgeschaltet.
+
+  \see
+  MotorLinSet(), motorlintab, MotorSpeed()\n
+  MY_MOTOR_CAL_SETTLE, MY_MOTOR_CAL_MEASURE in myasuro.h
+
+  \par  Hinweis:
+  Der Asuro faehrt dabei etwa 1 m geradeaus (oder wird aufgebockt, dann\n
+  gilt die Kennlinie aber fuer die Raeder ohne Last). Eine laufende\n
+  Geschwindigkeitsregelung wird mit CtrlStop() beendet, eine Rampe\n
+  (MotorSlew()) fuer die Dauer der Messung abgeschaltet.
+
+  \par  Funktionsweise:
+  Beide Motoren fahren vorwaerts die PWM 255, 240 .. 16, 0 ab. Von oben\n
+  nach unten, damit die Raeder schon laufen und die Haftreibung nicht\n
+  mitgemessen wird. Je Stufe wird MY_MOTOR_CAL_SETTLE ms gewartet und\n
+  MY_MOTOR_CAL_MEASURE ms gemessen. Aus den 17 Punkten je Motor wird die\n
+  Kennlinie so berechnet, dass die Vorgabe 256 beim schwaecheren Motor\n
+  PWM 255 ergibt und beide Motoren gleich schnell fahren.\n
+  Danach steht das Rad, und die PWM wird in Schritten von 4 wieder\n
+  hochgefahren, bis jedes Rad anlaeuft. Diese Anlauf-PWM aus dem Stand\n
+  (Haftreibung) liegt meist ueber der PWM, bei der das laufende Rad\n
+  stehen bleibt, und wird Eintrag 0 der Kennlinie.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  unsigned char i;
+
+  Init ();
+  if (MotorCalibrate ())
+  {
+    // Kennlinie ausgeben, um sie spaeter mit MotorLinSet() zu laden
+    for (i = 0; i < MOTOR_LIN_POINTS; i++)
+      PrintInt (motorlintab [LEFT][i]);
+    for (i = 0; i < MOTOR_LIN_POINTS; i++)
+      PrintInt (motorlintab [RIGHT][i]);
+    PrintInt (motorvmax);
+  }
+  MotorDir (FWD, FWD);
+  MotorSpeed (20, 20);                  // faehrt langsam geradeaus
+  \endcode
+*****************************************************************************/
+unsigned int MotorCalibrate (
+  void)
+{
+  int           v [2][MOTOR_LIN_POINTS];
+  int           m [2];
+  unsigned char tab [2][MOTOR_LIN_POINTS];
+  unsigned char start [2];
+  unsigned char k;
+  unsigned int  vmax;
+  unsigned int  slew = motorslew;
+
+  if (CtrlActive ())
+    CtrlStop ();
+  if (!autoencode)
+    EncoderInit ();
+  MotorLinSet (0, 0, 0);
+  MotorSlewSet (0);
+
+  MotorDir (FWD, FWD);
+  MOTOR_CAL_OCR (255);
+  Msleep (MY_MOTOR_CAL_SETTLE);         // aus dem Stand hochlaufen
+  k = MOTOR_LIN_POINTS;
+  while (k--)
+  {
+    MOTOR_CAL_OCR (MOTOR_CAL_PWM (k));
+    MotorCalMeasure (m);
+    v [LEFT][k]  = m [LEFT];
+    v [RIGHT][k] = m [RIGHT];
+  }
+  MotorCalBreakaway (start);            // Rad steht nach PWM 0
+  MotorSpeed (0, 0);
+  MotorDir (BREAK, BREAK);
+  MotorSlewSet (slew);
+
+  vmax = v [LEFT][MOTOR_LIN_POINTS - 1];
+  if (v [RIGHT][MOTOR_LIN_POINTS - 1] < (int) vmax)
+    vmax = v [RIGHT][MOTOR_LIN_POINTS - 1];
+  if ((int) vmax < MOTOR_CAL_VMIN ||
+      !MotorCalTable (tab [LEFT], v [LEFT], vmax, start [LEFT]) ||
+      !MotorCalTable (tab [RIGHT], v [RIGHT], vmax, start [RIGHT]))
+    return 0;
+
+  MotorLinSet (tab [LEFT], tab [RIGHT], vmax);
+  return vmax;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Laedt eine gespeicherte Kennlinie oder schaltet die Umrechnung in\n
+  MotorSpeed() aus.
+
+  \param[in]
+  left MOTOR_LIN_POINTS PWM-Werte fuer den linken Motor (siehe\n
+       motorlintab). NULL = Umrechnung aus.
+  \param[in]
+  right MOTOR_LIN_POINTS PWM-Werte fuer den rechten Motor
+  \param[in]
+  vmax Geschwindigkeit in mm/s bei der Vorgabe 256 (Rueckgabewert von\n
+       MotorCalibrate())
+
+  \return
+  nichts
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Werte aus einer frueheren Messung mit MotorCalibrate()
+  static const unsigned char links [MOTOR_LIN_POINTS] =
+    {62, 70, 79, 88, 97, 106, 116, 126, 136, 147, 158, 170, 183, 197, 213, 232, 255};
+  static const unsigned char rechts [MOTOR_LIN_POINTS] =
+    {58, 66, 74, 83, 92, 101, 110, 120, 130, 141, 152, 164, 176, 190, 205, 222, 242};
+
+  MotorLinSet (links, rechts, 390);
+  \endcode
+*****************************************************************************/
+void MotorLinSet (
+  const unsigned char *left,
+  const unsigned char *right,
+  unsigned int vmax)
+{
+  unsigned char i;
+
+  motorlin = FALSE;                     // Tabelle nicht waehrend der Nutzung aendern
+  if (!left || !right || vmax < 2)
+    return;
+  for (i = 0; i < MOTOR_LIN_POINTS; i++)
+  {
+    motorlintab [LEFT][i]  = left [i];
+    motorlintab [RIGHT][i] = right [i];
+  }
+  motorvmax   = vmax;
+  motorffgain = (unsigned int) ((65536UL + (vmax >> 1)) / vmax);
+  motorlin    = TRUE;
+}
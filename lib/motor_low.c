@@ -27,6 +27,25 @@
             Kommentierte Version (KEINE Funktionsaenderung)
   \version  V003 - 18.02.2007 - m.a.r.v.i.n\n
             Datei gesplitted in motor_low.c und motor.c 
+  \version  V004 - 17.10.2026\n
+            +++ MotorSpeed()\n
+            Begrenzung auf pwmlimit
+  \version  V005 - 17.10.2026\n
+            +++ MotorSpeed()\n
+            Kennlinie motorlintab (Totzone, Gleichlauf), sonst MY_MOTOR_DIFF
+  \version  V006 - 17.10.2026\n
+            +++ MotorPwmMode(), MotorSpeed16(), MotorPwmOcr()  NEU\n
+            PWM mit 9 oder 10 Bit bzw. 20 kHz, 16-Bit-Vorgaben
+  \version  V007 - 17.10.2026\n
+            +++ MotorSlewSet(), MotorSlewTick()  NEU\n
+            Rampe fuer PWM und Richtungswechsel (Stromspitzen)
+  \version  V008 - 17.10.2026\n
+            Ausgleich der Batteriespannung (motorvgain) in MotorSpeed()\n
+            und MotorSpeed16()
+  \version  V009 - 17.10.2026\n
+            Faktor fuer den Ausgleich der Batteriespannung wird in\n
+            MotorSpeed() aus motorvnom / motorvmv gerechnet, nicht mehr im\n
+            Interrupt SIG_ADC
 *****************************************************************************/
 /*****************************************************************************
 *                                                                            *
@@ -37,6 +56,255 @@
 *                                                                            *
 *****************************************************************************/
 #include "asuro.h"
+#include "myasuro.h"
+
+/*
+  Zustand der Rampe je Motor: Vorgabe 0..65535 (nach Kennlinie und
+  MY_MOTOR_DIFF) und Richtung, jeweils am Motor und gewuenscht.
+  Ohne Rampe sind beide immer gleich.
+*/
+static unsigned int  slewcur [2], slewtgt [2];
+static unsigned char slewdir [2] = {FWD, FWD};
+static unsigned char slewnext [2] = {FWD, FWD};
+
+/*
+  Grenzen fuer den Faktor aus Nennspannung / Batteriespannung (256 = 1.0),
+  damit ein Messfehler die PWM nicht vervielfacht
+*/
+#define MOTOR_VGAIN_MIN  128
+#define MOTOR_VGAIN_MAX  384
+
+/*
+  Zuletzt gerechneter Faktor und die Spannungen, aus denen er stammt.
+  Nur gemeinsam unter cli() aendern, MotorSpeed() laeuft auch im
+  Regeltakt (ctrl.c).
+*/
+static unsigned int  vgain, vgainnom, vgainmv;
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Vorgabe ueber die Kennlinie eines Motors in PWM umrechnen.
+
+  \param[in]
+  tab Kennlinie aus motorlintab
+  \param[in]
+  effort Vorgabe 0..255
+
+  \return
+  PWM 0..255
+
+  \par  Funktionsweise:
+  Stuetzstellen alle 16 Schritte, dazwischen linear interpoliert: zwei\n
+  Tabellenzugriffe und eine 8x8-Bit-Multiplikation. Die Vorgabe 0 ergibt\n
+  immer 0, die Vorgaben 1..15 beginnen bei der Anlauf-PWM in tab [0].
+*****************************************************************************/
+static inline unsigned char MotorLin (
+  const unsigned char *tab,
+  unsigned char effort)
+{
+  unsigned char i, lo, hi;
+
+  if (effort == 0)
+    return 0;
+  i  = effort >> 4;
+  lo = tab [i];
+  hi = tab [i + 1];
+  return lo + (unsigned char) (((hi - lo) * (effort & 0x0F)) >> 4);
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Wie MotorLin(), aber mit 16-Bit-Vorgabe und PWM * 256 als Ergebnis.
+
+  \param[in]
+  tab Kennlinie aus motorlintab
+  \param[in]
+  effort Vorgabe 0..65535
+
+  \return
+  PWM * 256 (0..65535)
+*****************************************************************************/
+static inline unsigned int MotorLin16 (
+  const unsigned char *tab,
+  unsigned int effort)
+{
+  unsigned char i, lo, hi;
+
+  if (effort == 0)
+    return 0;
+  i  = effort >> 12;
+  lo = tab [i];
+  hi = tab [i + 1];
+  return ((unsigned int) lo << 8) +
+         (unsigned int) (hi - lo) * (unsigned char) (effort >> 4);
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Liefert den Faktor fuer den Ausgleich der Batteriespannung.
+
+  \return
+  motorvnom / motorvmv * 256, begrenzt auf MOTOR_VGAIN_MIN..MOTOR_VGAIN_MAX.\n
+  0 = kein Ausgleich (aus oder noch kein Messwert).
+
+  \par  Hinweis:
+  Die 32-Bit-Division laeuft nur, wenn sich eine der beiden Spannungen\n
+  seit dem letzten Aufruf geaendert hat, und nie im Interrupt SIG_ADC\n
+  (dort wuerde sie Ticks vom 36 kHz Timer verschlucken).
+*****************************************************************************/
+static unsigned int MotorVgainGet (
+  void)
+{
+  unsigned int  nom, mv, gain;
+  unsigned char sreg = SREG;
+
+  cli ();
+  nom  = motorvnom;
+  mv   = motorvmv;
+  gain = vgain;
+  if (nom == vgainnom && mv == vgainmv)
+  {
+    SREG = sreg;
+    return gain;
+  }
+  SREG = sreg;
+
+  gain = 0;
+  if (nom && mv)
+  {
+    unsigned long g = ((unsigned long) nom << 8) / mv;
+
+    gain = (g < MOTOR_VGAIN_MIN) ? MOTOR_VGAIN_MIN :
+           (g > MOTOR_VGAIN_MAX) ? MOTOR_VGAIN_MAX : (unsigned int) g;
+  }
+  cli ();
+  vgain    = gain;
+  vgainnom = nom;
+  vgainmv  = mv;
+  SREG = sreg;
+  return gain;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Gleicht eine 16-Bit-Vorgabe an die Batteriespannung an.
+
+  \param[in]
+  speed 0..65535
+  \param[in]
+  gain Faktor aus MotorVgainGet() (256 = 1.0)
+
+  \return
+  speed * gain / 256, begrenzt auf 65535
+*****************************************************************************/
+static inline unsigned int MotorVgain (
+  unsigned int speed,
+  unsigned int gain)
+{
+  unsigned long s = ((unsigned long) speed * gain) >> 8;
+
+  return (s > 65535UL) ? 65535U : (unsigned int) s;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Setzt die Richtungs-Pins der H-Bruecken.
+
+  \param[in]
+  left_dir Richtung links [ FWD | RWD | BREAK | FREE ]
+  \param[in]
+  right_dir Richtung rechts [ FWD | RWD | BREAK | FREE ]
+
+  \return
+  nichts
+*****************************************************************************/
+static inline void MotorDirWrite (
+  unsigned char left_dir,
+  unsigned char right_dir)
+{
+  PORTD = (PORTD &~ ((1 << PD4) | (1 << PD5))) | left_dir;
+  PORTB = (PORTB &~ ((1 << PB4) | (1 << PB5))) | right_dir;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Gibt die fertige 16-Bit-Vorgabe beider Motoren aus oder merkt sie fuer\n
+  die Rampe vor.
+
+  \param[in]
+  left 0..65535
+  \param[in]
+  right 0..65535
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  16-Bit-Register von Timer 1 gehen ueber das gemeinsame TEMP-Register.\n
+  MotorSpeed() laeuft auch in Interrupts (ctrl.c, battery.c), daher\n
+  werden die Interrupts waehrend des Schreibens gesperrt.
+*****************************************************************************/
+static inline void MotorOut (
+  unsigned int left,
+  unsigned int right)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  slewtgt [LEFT]  = left;
+  slewtgt [RIGHT] = right;
+  if (!motorslew)
+  {
+    slewcur [LEFT]  = left;
+    slewcur [RIGHT] = right;
+    OCR1A = MotorPwmOcr (left);
+    OCR1B = MotorPwmOcr (right);
+  }
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Rechnet eine 16-Bit-Vorgabe in den Wert fuer OCR1A/OCR1B der mit\n
+  MotorPwmMode() eingestellten PWM um.
+
+  \param[in]
+  speed 0..65535 (0..100 %)
+
+  \return
+  0..motorpwmtop
+
+  \par  Hinweis:
+  Ein 8-Bit-Wert pwm entspricht speed = pwm * 257 (255 -> 65535).
+*****************************************************************************/
+unsigned int MotorPwmOcr (
+  unsigned int speed)
+{
+  if (motorpwmtop == 255)
+    return speed >> 8;
+  return (unsigned int) (((unsigned long) speed * (motorpwmtop + 1)) >> 16);
+}
 
 
 
@@ -54,7 +322,18 @@
   nichts
 
   \see
-  Die Initialisierung der PWM-Funktionalitaet erfolgt in der Funktion Init().
+  Die Initialisierung der PWM-Funktionalitaet erfolgt in der Funktion Init().\n
+  Die Werte werden auf die globale Variable pwmlimit begrenzt (siehe\n
+  BatteryCutoffPwm()).\n
+  Nach MotorCalibrate() oder MotorLinSet() sind die Werte keine PWM mehr,\n
+  sondern eine Vorgabe, die ueber die Kennlinie motorlintab jedes Motors\n
+  in PWM umgerechnet wird: ab 1 faehrt der Motor (Totzone uebersprungen),\n
+  die Geschwindigkeit steigt gleichmaessig mit der Vorgabe und beide\n
+  Motoren sind bei gleicher Vorgabe gleich schnell.\n
+  Ohne Kennlinie wird MY_MOTOR_DIFF aus myasuro.h je zur Haelfte auf\n
+  die beiden Werte verteilt.\n
+  Nach BatteryCompensate() wird die PWM zusaetzlich mit Nennspannung /\n
+  Batteriespannung malgenommen (vor pwmlimit).
 
   \par  Hinweis:
   Diese Funktion ist als 'inline'-Funktion definiert.
@@ -84,8 +363,180 @@ inline void MotorSpeed (
   unsigned char left_speed,
   unsigned char right_speed)
 {
-  OCR1A = left_speed;
-  OCR1B = right_speed;
+  unsigned int gain;
+
+  if (motorlin)
+  {
+    left_speed  = MotorLin (motorlintab [LEFT], left_speed);
+    right_speed = MotorLin (motorlintab [RIGHT], right_speed);
+  }
+#if MY_MOTOR_DIFF != 0
+  else
+  {
+    int l = left_speed, r = right_speed;
+
+    if (l)
+      l -= MY_MOTOR_DIFF / 2;           // positiv: links schwaecher ...
+    if (r)
+      r += MY_MOTOR_DIFF / 2;           // ... und rechts staerker
+    left_speed  = (l < 0) ? 0 : (l > 255) ? 255 : l;
+    right_speed = (r < 0) ? 0 : (r > 255) ? 255 : r;
+  }
+#endif
+  if ((gain = MotorVgainGet ()) != 0)
+  {
+    unsigned int lim = pwmlimit * 257U;
+    unsigned int l   = MotorVgain (left_speed * 257U, gain);
+    unsigned int r   = MotorVgain (right_speed * 257U, gain);
+
+    MotorOut ((l > lim) ? lim : l, (r > lim) ? lim : r);
+    return;
+  }
+  if (left_speed > pwmlimit)            // z.B. bei leerer Batterie
+    left_speed = pwmlimit;
+  if (right_speed > pwmlimit)
+    right_speed = pwmlimit;
+  MotorOut (left_speed * 257U, right_speed * 257U);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Steuert die Geschwindigkeit der Motoren mit 16 Bit Aufloesung.
+
+  \param[in]
+  left_speed  Geschwindigkeit linker Motor (Bereich 0..65535)
+  \param[in]
+  right_speed Geschwindigkeit rechter Motor (Bereich 0..65535)
+
+  \return
+  nichts
+
+  \see
+  MotorPwmMode(), MotorSpeed()
+
+  \par  Hinweis:
+  Wie MotorSpeed(), aber 65535 statt 255 = volle Leistung. Wie viele\n
+  Stufen davon an den Motoren ankommen, haengt von MotorPwmMode() ab:\n
+  256 nach Init(), 512 oder 1024 mit 9 oder 10 Bit, 400 mit 20 kHz.\n
+  Kennlinie (motorlintab), MY_MOTOR_DIFF und pwmlimit gelten wie bei\n
+  MotorSpeed(). Zwischen den Stuetzstellen der Kennlinie wird mit der\n
+  vollen Aufloesung interpoliert.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  MotorPwmMode (MOTOR_PWM_10BIT);
+  MotorDir (FWD, FWD);
+  MotorSpeed16 (20000, 20100);          // rechts ein wenig schneller
+  \endcode
+*****************************************************************************/
+void MotorSpeed16 (
+  unsigned int left_speed,
+  unsigned int right_speed)
+{
+  unsigned int lim = pwmlimit * 257U;
+  unsigned int gain;
+
+  if (motorlin)
+  {
+    left_speed  = MotorLin16 (motorlintab [LEFT], left_speed);
+    right_speed = MotorLin16 (motorlintab [RIGHT], right_speed);
+  }
+#if MY_MOTOR_DIFF != 0
+  else
+  {
+    long l = left_speed, r = right_speed;
+
+    if (l)
+      l -= MY_MOTOR_DIFF * 257L / 2;
+    if (r)
+      r += MY_MOTOR_DIFF * 257L / 2;
+    left_speed  = (l < 0) ? 0 : (l > 65535L) ? 65535U : l;
+    right_speed = (r < 0) ? 0 : (r > 65535L) ? 65535U : r;
+  }
+#endif
+  if ((gain = MotorVgainGet ()) != 0)
+  {
+    left_speed  = MotorVgain (left_speed, gain);
+    right_speed = MotorVgain (right_speed, gain);
+  }
+  if (left_speed > lim)
+    left_speed = lim;
+  if (right_speed > lim)
+    right_speed = lim;
+  MotorOut (left_speed, right_speed);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Stellt Aufloesung und Frequenz der Motor-PWM (Timer 1) ein.
+
+  \param[in]
+  mode
+  - MOTOR_PWM_8BIT  256 Stufen, 1.96 kHz (phasenkorrekt, Einstellung von Init())
+  - MOTOR_PWM_9BIT  512 Stufen, 15.6 kHz
+  - MOTOR_PWM_10BIT 1024 Stufen, 7.8 kHz
+  - MOTOR_PWM_20KHZ 400 Stufen, 20 kHz (ICR1 als TOP, nicht mehr hoerbar)
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Bei 8 MHz gibt es nur die Wahl zwischen Aufloesung und Frequenz:\n
+  Takt = Stufen * Frequenz. Ueber 20 kHz (unhoerbar) bleiben nur 400\n
+  Stufen, das sind aber immer noch mehr als die 256 von Init().\n
+  Die Motoren werden dabei angehalten (PWM 0). MotorSpeed() und\n
+  MotorSpeed16() rechnen danach selbst auf die neue Stufenzahl um,\n
+  alte 8-Bit-Programme laufen also unveraendert.\n
+  Mit hoeherer Frequenz wird die Totzone der Motoren meist etwas groesser,\n
+  eine Kennlinie aus MotorCalibrate() gilt daher nur fuer den Modus, in\n
+  dem sie gemessen wurde.
+
+  \par  Beispiel:
+  (siehe unter MotorSpeed16)
+*****************************************************************************/
+void MotorPwmMode (
+  unsigned char mode)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  switch (mode)
+  {
+    case MOTOR_PWM_9BIT:                // Fast PWM 9 Bit, MCU-Takt
+      TCCR1A = (1 << WGM11) | (1 << COM1A1) | (1 << COM1B1);
+      TCCR1B = (1 << WGM12) | (1 << CS10);
+      motorpwmtop = 511;
+      break;
+    case MOTOR_PWM_10BIT:               // Fast PWM 10 Bit, MCU-Takt
+      TCCR1A = (1 << WGM11) | (1 << WGM10) | (1 << COM1A1) | (1 << COM1B1);
+      TCCR1B = (1 << WGM12) | (1 << CS10);
+      motorpwmtop = 1023;
+      break;
+    case MOTOR_PWM_20KHZ:               // Fast PWM, TOP = ICR1, MCU-Takt
+      TCCR1A = (1 << WGM11) | (1 << COM1A1) | (1 << COM1B1);
+      TCCR1B = (1 << WGM13) | (1 << WGM12) | (1 << CS10);
+      ICR1   = F_CPU / 20000 - 1;
+      motorpwmtop = F_CPU / 20000 - 1;
+      break;
+    default:                            // wie Init(): phasenkorrekt 8 Bit
+      TCCR1A = (1 << WGM10) | (1 << COM1A1) | (1 << COM1B1);
+      TCCR1B = (1 << CS11);
+      motorpwmtop = 255;
+      break;
+  }
+  OCR1A = 0;
+  OCR1B = 0;
+  TCNT1 = 0;
+  slewcur [LEFT] = slewcur [RIGHT] = 0;
+  slewtgt [LEFT] = slewtgt [RIGHT] = 0;
+  SREG = sreg;
 }
 
 
@@ -104,7 +555,9 @@ inline void MotorSpeed (
   nichts
 
   \par  Hinweis:
-  Diese Funktion ist als 'inline'-Funktion definiert.
+  Diese Funktion ist als 'inline'-Funktion definiert.\n
+  Mit MotorSlew() wird die Richtung erst umgeschaltet, wenn die PWM des\n
+  Motors auf 0 heruntergefahren ist.
   
   \par  Arbeitsweise:
   Ueber die Parameter werden die Port-Pin's zu den H-Bruecken beider Motoren so\n
@@ -127,8 +580,131 @@ inline void MotorDir (
   unsigned char left_dir,
   unsigned char right_dir)
 {
-  PORTD = (PORTD &~ ((1 << PD4) | (1 << PD5))) | left_dir;
-  PORTB = (PORTB &~ ((1 << PB4) | (1 << PB5))) | right_dir;
+  unsigned char sreg = SREG;
+
+  cli ();
+  slewnext [LEFT]  = left_dir;
+  slewnext [RIGHT] = right_dir;
+  if (!motorslew)
+  {
+    slewdir [LEFT]  = left_dir;
+    slewdir [RIGHT] = right_dir;
+    MotorDirWrite (left_dir, right_dir);
+  }
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Schaltet die Rampe fuer die Motoren ein oder aus.
+
+  \param[in]
+  step Aenderung der 16-Bit-Vorgabe (0..65535) je Aufruf von\n
+       MotorSlewTick(). 0 = keine Rampe.
+
+  \return
+  nichts
+
+  \see
+  MotorSlew() in ctrl.c startet dazu auch den Takt.
+
+  \par  Hinweis:
+  Beim Ausschalten werden die zuletzt mit MotorSpeed()/MotorDir()\n
+  vorgegebenen Werte sofort ausgegeben. Sound() schaltet die Rampe\n
+  auf diese Weise fuer die Dauer des Tons ab.
+*****************************************************************************/
+void MotorSlewSet (
+  unsigned int step)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  motorslew = step;
+  if (!step)
+  {
+    slewcur [LEFT]  = slewtgt [LEFT];
+    slewcur [RIGHT] = slewtgt [RIGHT];
+    slewdir [LEFT]  = slewnext [LEFT];
+    slewdir [RIGHT] = slewnext [RIGHT];
+    MotorDirWrite (slewdir [LEFT], slewdir [RIGHT]);
+    OCR1A = MotorPwmOcr (slewcur [LEFT]);
+    OCR1B = MotorPwmOcr (slewcur [RIGHT]);
+  }
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Ein Schritt der Rampe. Laeuft im Regeltakt (SIG_OVERFLOW0 in ctrl.c).
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Jeder Motor bewegt sich um hoechstens motorslew auf die Vorgabe zu.\n
+  Soll die Richtung wechseln, wird erst bis 0 heruntergefahren, dann\n
+  umgeschaltet und in der neuen Richtung wieder hochgefahren. Ein\n
+  Wechsel von voll vorwaerts auf voll rueckwaerts dauert also doppelt so\n
+  lange wie das Anfahren. pwmlimit wird auch hier beachtet.\n
+  Laeuft mit freigegebenen Interrupts, nur das Lesen der Vorgabe und das\n
+  Schreiben der Register sind gesperrt.
+*****************************************************************************/
+void MotorSlewTick (
+  void)
+{
+  unsigned char side, sreg, next, turn = FALSE;
+  unsigned int  step = motorslew;
+  unsigned int  lim  = pwmlimit * 257U;
+  unsigned int  c, t;
+
+  for (side = LEFT; side <= RIGHT; side++)
+  {
+    sreg = SREG;
+    cli ();
+    t    = slewtgt [side];
+    next = slewnext [side];
+    SREG = sreg;
+
+    c = slewcur [side];
+    if (slewdir [side] != next)
+    {
+      if (c > step)
+        c -= step;
+      else
+      {
+        c = 0;                          // erst bei 0 umschalten
+        slewdir [side] = next;
+        turn = TRUE;
+      }
+    }
+    else
+    {
+      if (t > lim)
+        t = lim;
+      if (c < t)
+        c = (t - c > step) ? c + step : t;
+      else if (c > t)
+        c = (c - t > step) ? c - step : t;
+    }
+    slewcur [side] = c;
+  }
+
+  sreg = SREG;
+  cli ();
+  if (turn)
+    MotorDirWrite (slewdir [LEFT], slewdir [RIGHT]);
+  OCR1A = MotorPwmOcr (slewcur [LEFT]);
+  OCR1B = MotorPwmOcr (slewcur [RIGHT]);
+  SREG = sreg;
 }
 
 
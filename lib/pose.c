@@ -0,0 +1,289 @@
+/****************************************************************************/
+/*!
+  \file     pose.c
+
+  \brief    Positionsberechnung aus den Radencodern (Koppelnavigation).\n
+            Die Odometrie-Ticks werden im Interrupt nur gezaehlt, x, y und\n
+            Fahrtrichtung im Takt von Timer 0 in Festkomma nachgefuehrt.
+
+  \see      pose_t, POSE_DEG in pose.h\n
+            MY_GO_ENC_COUNT_VALUE, MY_TURN_ENC_COUNT_VALUE in myasuro.h
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            Sinustabelle nach fixmath.c verschoben (FixSin(), FixCos())
+  \version  V003 - 17.10.2026\n
+            PoseTick() zaehlt nur noch die Ticks, gerechnet wird in\n
+            PoseUpdate() im Takt von CtrlBackground() und in GetPose().\n
+            Die Rechnung im Interrupt SIG_ADC dauerte laenger als ein Takt\n
+            vom 36 kHz Timer.
+  \version  V004 - 17.10.2026\n
+            +++ PoseInit()\n
+            enchook mit gesperrten Interrupts setzen
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "asuro.h"
+#include "myasuro.h"
+#include "pose.h"
+#include "fixmath.h"
+#include "ctrl.h"
+
+/*
+  Weg der Fahrzeugmitte je Tick eines Rades: ein halber Tick in mm * 65536
+  (MY_GO_ENC_COUNT_VALUE / 10000 mm je Tick).
+  Drehung je Tick: 360 Grad / (2 * MY_TURN_ENC_COUNT_VALUE), als 32-Bit
+  Winkel mit 2^32 = 360 Grad.
+*/
+#define POSE_STEP     ((MY_GO_ENC_COUNT_VALUE * 65536L) / 20000L)
+#define POSE_DTHETA   (0x80000000UL / MY_TURN_ENC_COUNT_VALUE)
+
+/*
+  POSE_STEP * FixCos() muss in 32 Bit passen
+*/
+#if (MY_GO_ENC_COUNT_VALUE * 65536L) / 20000L * 32767L > 0x7FFFFFFFL
+#error "MY_GO_ENC_COUNT_VALUE zu gross fuer pose.c"
+#endif
+
+static long          posex, posey;      // mm * 65536
+static unsigned long posetheta;         // 2^32 = 360 Grad
+static volatile int  poseticks [2];     // Ticks seit PoseUpdate(), mit Vorzeichen
+static volatile unsigned char posebusy; // PoseUpdate() rechnet gerade
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Rueckruffunktion fuer enchook. Laeuft im Interrupt SIG_ADC mit jedem\n
+  Odometrie-Tick und zaehlt nur die Ticks.
+
+  \param[in]
+  side LEFT oder RIGHT
+  \param[in]
+  dir +1 vorwaerts, -1 rueckwaerts
+
+  \return
+  nichts
+*****************************************************************************/
+static void PoseTick (
+  unsigned char side,
+  signed char dir)
+{
+  poseticks [side] += dir;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Rechnet die seit dem letzten Aufruf gezaehlten Ticks in Position und\n
+  Richtung um. Laeuft im Takt von Timer 0 (CtrlBackground()) und in\n
+  GetPose().
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Funktionsweise:
+  Ein Tick links vorwaerts dreht das Fahrzeug rechts herum, ein Tick\n
+  rechts vorwaerts links herum. Die Mitte wird in Richtung des halben\n
+  Drehwinkels verschoben (Mittelpunktregel). Im 8 ms Takt sind das nur\n
+  wenige Ticks, das Ergebnis ist praktisch dasselbe wie mit jedem Tick\n
+  einzeln. Aufwand je Aufruf: zwei Tabellenzugriffe mit Interpolation\n
+  und vier 32-Bit-Multiplikationen.\n
+  posebusy verhindert, dass sich zwei Aufrufe (Programm und Timer 0)\n
+  ueberholen. Wer dabei zu spaet kommt, rechnet nicht und liefert den\n
+  letzten Stand.
+*****************************************************************************/
+static void PoseUpdate (
+  void)
+{
+  int           dl, dr;
+  long          x, y, step;
+  unsigned long theta, half;
+  unsigned int  mid;
+  unsigned char sreg = SREG;
+
+  cli ();
+  if (posebusy)
+  {
+    SREG = sreg;
+    return;
+  }
+  dl = poseticks [LEFT];
+  dr = poseticks [RIGHT];
+  poseticks [LEFT] = poseticks [RIGHT] = 0;
+  if (dl == 0 && dr == 0)
+  {
+    SREG = sreg;
+    return;
+  }
+  posebusy = TRUE;
+  x     = posex;
+  y     = posey;
+  theta = posetheta;
+  SREG = sreg;
+
+  half   = (unsigned long) (long) (dr - dl) * (POSE_DTHETA / 2);
+  mid    = (theta + half) >> 16;       // Richtung nach der halben Drehung
+  theta += (unsigned long) (long) (dr - dl) * POSE_DTHETA;    // modulo 2^32
+  step   = (POSE_STEP * FixCos (mid)) >> 15;
+  x     += step * (dl + dr);
+  step   = (POSE_STEP * FixSin (mid)) >> 15;
+  y     += step * (dl + dr);
+
+  cli ();
+  posex     = x;
+  posey     = y;
+  posetheta = theta;
+  posebusy  = FALSE;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Startet die Positionsberechnung. Position und Richtung sind danach 0.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Laeuft die Odometrie noch nicht, wird EncoderInit() aufgerufen.\n
+  Die Richtung eines Ticks kommt aus MotorDir() (siehe enctick).\n
+  Gerechnet wird im Takt von Timer 0 (CtrlBackground() in ctrl.c),\n
+  der dafuer gestartet wird.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  pose_t p;
+
+  PoseInit ();
+  GoTurn (300, 0, 150);
+  GoTurn (0, 90, 150);
+  GetPose (&p);
+  PrintInt (p.x);                       // ca. 300
+  PrintInt (POSE_DEG (p.theta));        // ca. 270 (rechts herum)
+  \endcode
+*****************************************************************************/
+void PoseInit (
+  void)
+{
+  unsigned char sreg;
+
+  if (!autoencode)
+    EncoderInit ();
+  PoseSet (0, 0, 0);
+  sreg = SREG;
+  cli ();
+  enchook = PoseTick;                   // 16-Bit-Zeiger, nicht atomar
+  SREG = sreg;
+  CtrlBackground (PoseUpdate);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Beendet die Positionsberechnung.
+
+  \param
+  keine
+
+  \return
+  nichts
+*****************************************************************************/
+void PoseStop (
+  void)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  enchook = 0;
+  SREG = sreg;
+  CtrlBackground (0);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Setzt Position und Richtung.
+
+  \param[in]
+  x Position in mm
+  \param[in]
+  y Position in mm
+  \param[in]
+  theta Richtung, 65536 = 360 Grad, links herum
+
+  \return
+  nichts
+*****************************************************************************/
+void PoseSet (
+  int x,
+  int y,
+  unsigned int theta)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  posex     = (long) x << 16;
+  posey     = (long) y << 16;
+  posetheta = (unsigned long) theta << 16;
+  poseticks [LEFT] = poseticks [RIGHT] = 0;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert Position und Richtung in einem Zug.
+
+  \param[out]
+  pose x, y in mm (gerundet), theta mit 65536 = 360 Grad
+
+  \return
+  nichts
+
+  \par  Beispiel:
+  (siehe unter PoseInit)
+*****************************************************************************/
+void GetPose (
+  pose_t *pose)
+{
+  long          x, y;
+  unsigned long t;
+  unsigned char sreg = SREG;
+
+  PoseUpdate ();
+  cli ();
+  x = posex;
+  y = posey;
+  t = posetheta;
+  SREG = sreg;
+  pose->x     = (int) ((x + 0x8000L) >> 16);
+  pose->y     = (int) ((y + 0x8000L) >> 16);
+  pose->theta = (unsigned int) ((t + 0x8000UL) >> 16);
+}
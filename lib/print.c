@@ -44,6 +44,10 @@
   \version  V005 - 18.08.2007 - marvin\n
             +++ SerPrint ()\n
             signed char als Parameter wg. Compilerwarnungen
+  \version  V006 - 17.10.2026\n
+            +++ UartPutc ()\n
+            Zeichen ueber den Sendepuffer von SerWrite() ausgeben. Alle Print\n
+            Funktionen kehren dadurch sofort zurueck.
 *****************************************************************************/
 /*****************************************************************************
 *                                                                            *
@@ -161,6 +165,11 @@ void PrintLong (
   \version  V004 - 25.07.2007 - Sternthaler (Gemeldet von helmut_w)\n
             Abschalten des Senders nach der Datenuebertragung zum sparen
             von Energie.
+  \version  V006 - 17.10.2026\n
+            Zeichen nur noch in den Sendepuffer legen. Das Abschalten des\n
+            Senders erfolgt im Interrupt (siehe uart.c).
+
+  \see SerWrite, SerFlush
 
   \par  Beispiel:
   (Nur zur Demonstration der Parameter/Returnwerte)
@@ -176,14 +185,7 @@ void PrintLong (
 void UartPutc (
   unsigned char zeichen)
 {
-  UCSRB  = 0x08;                        // enable transmitter
-  UCSRA |= 0x40;                        // clear transmitter flag
-  while (!(UCSRA & 0x20))               // wait for empty transmit buffer
-    ;
-  UDR = zeichen;
-  while (!(UCSRA & 0x40))               // Wait for transmit complete flag (TXC)
-    ;
-  UCSRB  = 0x00;                        // disable transmitter / powersave
+  SerWrite (&zeichen, 1);               // in den Sendepuffer, nicht warten
 }
 
 
@@ -25,6 +25,8 @@
             Einheitliche Formatierung zu den anderen Sourcen.
   \version  V003 - 26.06.2007 - stochri\n
             Bugfix Fehler in der Soundlaenge (max. 250ms)  
+  \version  V004 - 17.10.2026\n
+            Rampe der Motoren (MotorSlew()) fuer die Dauer des Tons aus
             
 *****************************************************************************/
 /*****************************************************************************
@@ -54,6 +56,10 @@
   \return
   nichts
 
+  \par  Hinweis:
+  Eine mit MotorSlew() eingestellte Rampe wuerde die Umschaltung der\n
+  Richtung verschlucken. Sie wird fuer die Dauer des Tons abgeschaltet.
+
   \par  Beispiel:
   (Nur zur Demonstration der Parameter/Returnwerte)
   \code
@@ -69,6 +75,7 @@ void Sound (
 {
   uint16_t wait_tics;
   uint32_t n,k,period_usec,dauer_usec;
+  uint16_t slew = motorslew;
 
   period_usec = 1000000L / freq;
   dauer_usec = 1000 * (uint32_t) duration_msec;
@@ -79,6 +86,7 @@ void Sound (
 
   wait_tics = 18000 / freq;
 
+  MotorSlewSet (0);
   MotorSpeed (amplitude, amplitude);
 
   for (n = 0; n < k; n++)
@@ -89,6 +97,7 @@ void Sound (
     Sleep (wait_tics);
   }
   MotorSpeed (0, 0);
+  MotorSlewSet (slew);
 }
 
 #define BEEP sound (1000, 100, 255)
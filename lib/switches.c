@@ -24,6 +24,18 @@
             Korrektur im Code-Beispiel
   \version  V004 - 20.02.2007 - m.a.r.v.i.n\n
             Korrekturfaktur aus myasuro.h verwenden
+  \version  V005 - 17.10.2026\n
+            +++ PollSwitch()\n
+            Messwert ueber AdcRead() aus dem ADC Sequencer
+  \version  V006 - 17.10.2026\n
+            +++ SwitchInit(), SwitchEvent()  NEU\n
+            Entprellter Tastentreiber mit Ereignis-Warteschlange im ADC\n
+            Sequencer. PollSwitch() liefert dann nur noch den Zustand.\n
+            Tastenwerte ueber die Tabelle switchband statt Division.
+  \version  V007 - 17.10.2026\n
+            +++ SwitchPush(), SwitchEvent()\n
+            Im Interrupt nur noch den Zeitstempel von Timer 2 merken, die\n
+            Umrechnung in ms (Division) macht SwitchEvent().
 *****************************************************************************/
 /*****************************************************************************
 *                                                                            *
@@ -33,9 +45,257 @@
 *   any later version.                                                       *
 *                                                                            *
 *****************************************************************************/
+#include <avr/pgmspace.h>
 #include "asuro.h"
 #include "myasuro.h"
 
+/*
+  Tabelle der Tastenwerte.
+  PollSwitch() hat den Tastenwert d frueher mit
+    d = (1024 / adc - 1) * MY_SWITCH_VALUE + 0.5
+  berechnet. d >= n gilt genau dann, wenn
+    adc <= 2048 * MY_SWITCH_VALUE / (2 * MY_SWITCH_VALUE + 2 * n - 1)
+  ist. Die Grenzen fuer n = 1..64 werden hier vom Compiler berechnet. Jeder
+  Tastenwert hat damit ein Toleranzband bis zur Mitte des Nachbarwertes und
+  wird mit einer binaeren Suche ohne Division gefunden.
+*/
+#define SWITCH_BAND(n) \
+  ((unsigned int) ((2048L * MY_SWITCH_VALUE) / (2L * MY_SWITCH_VALUE + 2 * (n) - 1)))
+#define SWITCH_BAND4(n) \
+  SWITCH_BAND (n), SWITCH_BAND (n + 1), SWITCH_BAND (n + 2), SWITCH_BAND (n + 3)
+
+static const unsigned int switchband [64] PROGMEM =
+{
+  SWITCH_BAND4 (1),  SWITCH_BAND4 (5),  SWITCH_BAND4 (9),  SWITCH_BAND4 (13),
+  SWITCH_BAND4 (17), SWITCH_BAND4 (21), SWITCH_BAND4 (25), SWITCH_BAND4 (29),
+  SWITCH_BAND4 (33), SWITCH_BAND4 (37), SWITCH_BAND4 (41), SWITCH_BAND4 (45),
+  SWITCH_BAND4 (49), SWITCH_BAND4 (53), SWITCH_BAND4 (57), SWITCH_BAND4 (61)
+};
+
+/*
+  Haltezeit in timebase Schritten (256 / 36 kHz = 7.1 ms)
+*/
+#define SWITCH_HOLD_TICKS ((unsigned int) ((MY_SWITCH_HOLD * 36L) / 256))
+
+/*
+  Zustand vom Tastentreiber (wird im Interrupt SIG_ADC bearbeitet)
+*/
+static unsigned char  swraw;            // letzter dekodierter Wert
+static unsigned char  swcnt;            // gleiche Werte hintereinander
+static volatile unsigned char swstable; // entprellter Zustand
+static unsigned char  swheld;           // SWITCH_HOLD schon gemeldet
+static unsigned int   swsince;          // timebase beim letzten Wechsel
+static switch_event_t swqueue [MY_SWITCH_QUEUE];
+static unsigned long  swstamp [MY_SWITCH_QUEUE]; // (timebase << 8) | count36kHz
+static volatile unsigned char swhead, swtail;
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Wandelt einen ADC-Wert des Taster-Kanals in die Tastenbits um.
+
+  \param[in]
+  adc 10-Bit-Wert vom Kanal SWITCH
+
+  \return
+  Tastenwert bitorientiert, K1 = Bit5 ... K6 = Bit0
+*****************************************************************************/
+static unsigned char SwitchDecode (
+  unsigned int adc)
+{
+  unsigned char lo = 0, hi = 64, mid;
+
+  /*
+    Die Grenzen fallen mit n. Gesucht ist die Anzahl der Grenzen >= adc.
+  */
+  while (lo < hi)
+  {
+    mid = (lo + hi) >> 1;
+    if (adc <= pgm_read_word (&switchband [mid]))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return (lo > 63) ? 63 : lo;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Legt ein Ereignis in der Warteschlange ab. Ist sie voll, geht das\n
+  Ereignis verloren.\n
+  Laeuft im Interrupt SIG_ADC. Wie bei enctime wird nur der Stand von\n
+  Timer 2 gemerkt, Gettime() wuerde hier durch 36 teilen.
+*****************************************************************************/
+static void SwitchPush (
+  unsigned char type,
+  unsigned char keys)
+{
+  unsigned char next = (swhead + 1) & (MY_SWITCH_QUEUE - 1);
+
+  if (next == swtail)
+    return;
+  swqueue [swhead].type = type;
+  swqueue [swhead].keys = keys;
+  swstamp [swhead] = (timebase << 8) | count36kHz;
+  swhead = next;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Rueckruffunktion fuer den Taster-Kanal des ADC Sequencers. Entprellt\n
+  die Tastenwerte und erzeugt die Ereignisse. Laeuft im Interrupt SIG_ADC.
+
+  \param[in]
+  adc neuer 10-Bit-Wert vom Kanal SWITCH
+
+  \par  Funktionsweise:
+  Ein Tastenwert gilt erst, wenn er MY_SWITCH_DEBOUNCE mal hintereinander\n
+  gemessen wurde. Dann werden fuer neu gedrueckte Tasten SWITCH_PRESS und\n
+  fuer losgelassene Tasten SWITCH_RELEASE erzeugt. Bleibt ein Zustand mit\n
+  gedrueckten Tasten MY_SWITCH_HOLD ms stehen, folgt einmal SWITCH_HOLD.
+*****************************************************************************/
+static void SwitchHook (
+  unsigned int adc)
+{
+  unsigned char keys = SwitchDecode (adc);
+  unsigned char old;
+
+  if (keys != swraw)
+  {
+    swraw = keys;                       // Wert hat sich geaendert
+    swcnt = 1;
+    return;
+  }
+  if (swcnt < MY_SWITCH_DEBOUNCE)
+    swcnt ++;
+  if (swcnt < MY_SWITCH_DEBOUNCE)
+    return;
+
+  old = swstable;
+  if (keys != old)
+  {
+    if (keys & ~old)
+    {
+      SwitchPush (SWITCH_PRESS, keys & ~old);
+      switched = 1;                     // wie im Interrupt-Betrieb
+    }
+    if (old & ~keys)
+      SwitchPush (SWITCH_RELEASE, old & ~keys);
+    swstable = keys;
+    swheld   = FALSE;
+    swsince  = (unsigned int) timebase;
+  }
+  else if (keys && !swheld &&
+           (unsigned int) timebase - swsince >= SWITCH_HOLD_TICKS)
+  {
+    SwitchPush (SWITCH_HOLD, keys);
+    swheld = TRUE;
+  }
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Startet den Tastentreiber im Hintergrund.\n
+  Der ADC Sequencer misst die Taster, entprellt sie und legt Ereignisse\n
+  (gedrueckt, losgelassen, gehalten) mit Zeitstempel in einer Warteschlange\n
+  ab. PollSwitch() liefert danach den entprellten Zustand ohne zu warten.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Steht SWITCH nicht in der Kanalliste des ADC Sequencers, wird der Kanal\n
+  angehaengt.\n
+  StartSwitch() kann weiterhin benutzt werden, z.B. um den Asuro aus dem\n
+  Sleep-Mode zu wecken. Solange INT1 scharf ist, misst der Sequencer die\n
+  Taster nicht. Der Interrupt SIG_INTERRUPT1 sperrt INT1 beim Tastendruck\n
+  wieder, danach misst der Sequencer weiter und der Tastendruck kommt als\n
+  SWITCH_PRESS aus dem Tastentreiber.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  switch_event_t ev;
+
+  SwitchInit ();
+  while (1)
+  {
+    if (SwitchEvent (&ev) && ev.type == SWITCH_PRESS && (ev.keys & K1))
+      StatusLED (RED);
+  }
+  \endcode
+*****************************************************************************/
+void SwitchInit (
+  void)
+{
+  unsigned char sreg = SREG;
+
+  AdcHook (SWITCH, 0);
+
+  cli ();
+  swraw    = 0;
+  swcnt    = 0;
+  swstable = 0;
+  swheld   = FALSE;
+  swhead   = swtail = 0;
+  if (!AdcScanned (SWITCH) && !(GICR & (1 << INT1)) &&
+      adcscanlen < ADC_SCAN_MAX)
+    adcscan [adcscanlen++] = SWITCH;
+  SREG = sreg;
+  if (!adcscanon)
+    AdcScanStart ();
+
+  AdcHook (SWITCH, SwitchHook);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Holt das naechste Ereignis aus der Warteschlange vom Tastentreiber.
+
+  \param[out]
+  ev Ereignis: Typ (SWITCH_PRESS, SWITCH_RELEASE, SWITCH_HOLD), Tasten\n
+     und Zeitstempel
+
+  \return
+  TRUE, wenn ein Ereignis geliefert wurde, FALSE bei leerer Warteschlange
+
+  \par  Beispiel:
+  (siehe unter SwitchInit)
+*****************************************************************************/
+unsigned char SwitchEvent (
+  switch_event_t *ev)
+{
+  unsigned long stamp;
+  unsigned char sreg = SREG;
+
+  if (swhead == swtail)
+    return FALSE;
+  cli ();
+  *ev   = swqueue [swtail];
+  stamp = swstamp [swtail];
+  swtail = (swtail + 1) & (MY_SWITCH_QUEUE - 1);
+  SREG = sreg;
+  ev->time = (unsigned int) (stamp / 36);   // wie Gettime()
+  return TRUE;
+}
+
 
 
 /****************************************************************************/
@@ -51,13 +311,18 @@
   K5 = Bit1, K6 = Bit0
 
   \see
-  Die globale Variable autoencode wird temporaer auf FALSE gesetzt und am Ende\n
-  der Funktion mit dem alten Wert restauriert.
+  SwitchInit(): Laeuft der Tastentreiber, wird nur der entprellte Zustand\n
+  zurueckgegeben. Die Funktion muss dann nicht mehr doppelt aufgerufen\n
+  werden.\n
+  AdcRead(): Sonst kommt der Wert aus dem ADC Sequencer, solange dieser den\n
+  Kanal SWITCH misst. Der Sequencer schaltet SWITCH_ON dann selbst.
 
   \par  Hinweis:
-  In dieser Funktion sind 2 Sleep() Aufrufe vorhanden. Sie werden benoetigt\n
-  damit der Kondensator an der AD-Wandlereinheit genuegend Zeit hat geladen\n
-  zu werden.
+  Bei einer direkten Messung sind 2 Sleep() Aufrufe vorhanden. Sie werden\n
+  benoetigt damit der Kondensator an der AD-Wandlereinheit genuegend Zeit\n
+  hat geladen zu werden.\n
+  Ist der 'Interrupt-Betrieb' mit StartSwitch() eingeschaltet, misst der\n
+  Sequencer den Kanal nicht. Dann wird wie bisher direkt gemessen.
 
   \par  Beispiel:
   (Nur zur Demonstration der Parameter/Returnwerte)
@@ -83,32 +348,33 @@
 unsigned char PollSwitch (void)
 {
   unsigned int i;
-  int ec_bak = autoencode;              // Sichert aktuellen Zustand
+  unsigned char sreg = SREG;
+  unsigned char direct;
+
+  if (adchook [SWITCH] == SwitchHook && !(GICR & (1 << INT1)))
+    return swstable;                    // Tastentreiber laeuft
 
   /*
-     Autoencode-Betrieb vom ADC-Wandler unterbinden.
+     Misst der Sequencer den Kanal nicht, muss der Taster-Port hier
+     geschaltet werden.
   */
-  autoencode = FALSE;
-
-  DDRD |= SWITCHES;                     // Port-Bit SWITCHES als Output
-  SWITCH_ON;                            // Port-Bit auf HIGH zur Messung
-  ADMUX = (1 << REFS0) | SWITCH;        // AVCC reference with external capacitor
-  Sleep (10);
-
-  ADCSRA |= (1 << ADSC);                // Starte AD-Wandlung
-  while (!(ADCSRA & (1 << ADIF)))       // Ende der AD-Wandlung abwarten
-    ;
-  ADCSRA |= (1 << ADIF);                // AD-Interupt-Flag zuruecksetzen
-
-  i = ADCL + (ADCH << 8);               // Ergebnis als 16-Bit-Wert
+  cli ();
+  direct = !AdcScanned (SWITCH);
+  if (direct)
+  {
+    DDRD |= SWITCHES;                   // Port-Bit SWITCHES als Output
+    SWITCH_ON;                          // Port-Bit auf HIGH zur Messung
+  }
+  SREG = sreg;
 
-  SWITCH_OFF;                           // Port-Bit auf LOW
-  Sleep (5);
+  // AVCC reference with external capacitor
+  i = AdcRead ((1 << REFS0) | SWITCH, 10);
 
-  /*
-     Autoencode-Betrieb vom ADC-Wandler wiederherstellen.
-  */
-  autoencode = ec_bak;
+  if (direct)
+  {
+    SWITCH_OFF;                         // Port-Bit auf LOW
+    Sleep (5);
+  }
 
   /*
     Die Original Umrechenfunktion von Jan Grewe - DLR wurder ersetzt durch
@@ -116,8 +382,9 @@ unsigned char PollSwitch (void)
   return  ((unsigned char) ((( 1024.0/(float)i - 1.0)) * 61.0 + 0.5));
 
     Wert 61L evtl. anpasssen, falls fuer K1 falsche Werte zurueckgegebn werden.
+    Die Rechnung steckt jetzt in der Tabelle switchband.
   */
-  return ((10240000L / (long)i - 10000L) * MY_SWITCH_VALUE + 5000L) / 10000;
+  return SwitchDecode (i);
 }
 
 
@@ -0,0 +1,407 @@
+/****************************************************************************/
+/*!
+  \file     telemetry.c
+
+  \brief    Binaere Telemetrie ueber die serielle Schnittstelle.\n
+            Messwerte werden als Datensatz mit Zeitstempel und CRC-8 in\n
+            einen COBS Rahmen verpackt und ueber den Sendepuffer von\n
+            SerWrite() ausgegeben. Das Format ist in telemetry.h beschrieben.
+
+  \see      Datensatz Typen TLM_xxx in telemetry.h\n
+            tools/tlmdecode.c fuer die Auswertung am PC.
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            +++ TlmStreamInit(), TlmStreamAdd(), TlmStreamFlush()  NEU\n
+            Delta/Varint kodierte Streams fuer periodische Messwerte.
+  \version  V003 - 17.10.2026\n
+            --- TlmStreamAdd() schrieb bei 8 Kanaelen mit grossen Spruengen\n
+            ueber das Ende von buf. Maximal 7 Kanaele, 1 + 3 * 7 Byte\n
+            passen immer in einen Rahmen.
+  \version  V004 - 17.10.2026\n
+            --- TlmEncoder() stellt SREG wieder her, statt die Interrupts\n
+            immer freizugeben.
+  \version  V005 - 17.10.2026\n
+            --- Stream Rahmen trugen die Zeit vom Senden, also vom ersten\n
+            Sample des folgenden Rahmens. TlmStreamAdd() merkt sich jetzt\n
+            Gettime() beim ersten Sample, TlmStreamFlush() sendet diese Zeit.
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include <util/crc16.h>
+#include "asuro.h"
+#include "telemetry.h"
+
+
+
+/* Rahmen mit vorgegebener Zeit kodieren und senden, siehe TlmSend() */
+static void TlmFrame (
+  unsigned char type,
+  unsigned int time,
+  const void *data,
+  unsigned char length)
+{
+  unsigned char raw [3 + TLM_MAX_DATA + 1];
+  unsigned char out [sizeof (raw) + 2];
+  unsigned char crc = 0;
+  unsigned char i, n, code, pos;
+
+  if (length > TLM_MAX_DATA)
+    length = TLM_MAX_DATA;
+
+  /*
+    Rohdaten zusammenstellen: Typ, Zeit, Nutzdaten, CRC
+  */
+  raw [0] = type;
+  raw [1] = (unsigned char) time;
+  raw [2] = (unsigned char) (time >> 8);
+  for (i = 0; i < length; i++)
+    raw [3 + i] = ((const unsigned char *) data) [i];
+  n = 3 + length;
+  for (i = 0; i < n; i++)
+    crc = _crc_ibutton_update (crc, raw [i]);
+  raw [n++] = crc;
+
+  /*
+    COBS kodieren. pos zeigt auf das Laengenbyte vom aktuellen Block.
+  */
+  pos  = 0;
+  code = 1;
+  for (i = 0; i < n; i++)
+  {
+    if (raw [i] == 0)
+    {
+      out [pos] = code;
+      pos += code;
+      code = 1;
+    }
+    else
+    {
+      out [pos + code] = raw [i];
+      code ++;
+    }
+  }
+  out [pos] = code;
+  pos += code;
+  out [pos++] = 0x00;                   // Rahmenende
+
+  SerWrite (out, pos);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Sendet einen Datensatz als Telemetrie-Rahmen.
+
+  \param[in]
+  type   Datensatz Typ (TLM_xxx oder ab TLM_USER eigene Typen)
+  \param[in]
+  data   Nutzdaten
+  \param[in]
+  length Laenge der Nutzdaten (maximal TLM_MAX_DATA, der Rest wird\n
+         abgeschnitten)
+
+  \return
+  nichts
+
+  \par  Arbeitsweise:
+  Der Rahmen wird direkt beim Kopieren COBS kodiert: jedes 0x00 wird durch\n
+  den Abstand zum naechsten 0x00 ersetzt, der jeweils vor dem Block steht.\n
+  Da ein Rahmen kuerzer als 254 Byte ist, kommt genau ein Byte dazu.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // eigener Datensatz: Sollwert und Istwert der Regelung
+  int wert [2];
+
+  wert [0] = soll;
+  wert [1] = ist;
+  TlmSend (TLM_USER, wert, sizeof (wert));
+  \endcode
+*****************************************************************************/
+void TlmSend (
+  unsigned char type,
+  const void *data,
+  unsigned char length)
+{
+  TlmFrame (type, (unsigned int) Gettime (), data, length);
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Sendet die aktuellen Odometrie Zaehler encoder[] als TLM_ENCODER.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // ersetzt PrintInt (encoder [0]); SerPrint (" "); PrintInt (encoder [1]);
+  EncoderInit ();
+  while (1)
+  {
+    TlmEncoder ();
+    Msleep (50);
+  }
+  \endcode
+*****************************************************************************/
+void TlmEncoder (void)
+{
+  int16_t data [2];
+  unsigned char sreg = SREG;
+
+  cli ();                               // beide Werte aus einem Guss
+  data [LEFT]  = encoder [LEFT];
+  data [RIGHT] = encoder [RIGHT];
+  SREG = sreg;
+  TlmSend (TLM_ENCODER, data, sizeof (data));
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Sendet die Werte der Liniensensoren als TLM_LINE.
+
+  \param[in]
+  data Werte von LineData(), data[LEFT], data[RIGHT]
+
+  \return
+  nichts
+*****************************************************************************/
+void TlmLine (
+  const unsigned int *data)
+{
+  uint16_t buf [2];
+
+  buf [LEFT]  = data [LEFT];
+  buf [RIGHT] = data [RIGHT];
+  TlmSend (TLM_LINE, buf, sizeof (buf));
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Sendet die Werte der Odometriesensoren als TLM_ODOMETRY.
+
+  \param[in]
+  data Werte von OdometryData(), data[LEFT], data[RIGHT]
+
+  \return
+  nichts
+*****************************************************************************/
+void TlmOdometry (
+  const unsigned int *data)
+{
+  uint16_t buf [2];
+
+  buf [LEFT]  = data [LEFT];
+  buf [RIGHT] = data [RIGHT];
+  TlmSend (TLM_ODOMETRY, buf, sizeof (buf));
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Sendet den Batteriewert als TLM_BATTERY.
+
+  \param[in]
+  value Wert von Battery() (Bereich 0..1023)
+
+  \return
+  nichts
+*****************************************************************************/
+void TlmBattery (
+  int value)
+{
+  uint16_t buf = value;
+
+  TlmSend (TLM_BATTERY, &buf, sizeof (buf));
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Sendet die Tasterbits als TLM_SWITCH.
+
+  \param[in]
+  value Wert von PollSwitch()
+
+  \return
+  nichts
+*****************************************************************************/
+void TlmSwitch (
+  unsigned char value)
+{
+  TlmSend (TLM_SWITCH, &value, 1);
+}
+
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Bereitet einen Delta-Stream vor.
+
+  \param[out]
+  s        Zustand vom Stream
+  \param[in]
+  id       Stream Nummer 0..15, wird als Typ TLM_STREAM + id gesendet
+  \param[in]
+  channels Anzahl Kanaele pro Sample (1..TLM_STREAM_CHANNELS)
+  \param[in]
+  keyint   Alle keyint Samples wird ein Keyframe gesendet (1 = immer)
+
+  \return
+  nichts
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Liniensensoren alle 10 ms, jede Sekunde ein Keyframe
+  tlm_stream_t line;
+  unsigned int data [2];
+
+  TlmStreamInit (&line, 0, 2, 100);
+  FrontLED (ON);
+  while (1)
+  {
+    LineData (data);
+    TlmStreamAdd (&line, (int *) data);
+    Msleep (10);
+  }
+  \endcode
+*****************************************************************************/
+void TlmStreamInit (
+  tlm_stream_t *s,
+  unsigned char id,
+  unsigned char channels,
+  unsigned char keyint)
+{
+  if (channels > TLM_STREAM_CHANNELS)
+    channels = TLM_STREAM_CHANNELS;
+  if (channels == 0)
+    channels = 1;
+  s->id       = id & 0x0F;
+  s->channels = channels;
+  s->keyint   = keyint ? keyint : 1;
+  s->count    = 0;
+  s->seq      = 0;
+  s->len      = 0;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Sendet den offenen Rahmen eines Streams, auch wenn er noch nicht voll ist.
+
+  \param[in,out]
+  s Zustand vom Stream
+
+  \return
+  nichts
+*****************************************************************************/
+void TlmStreamFlush (
+  tlm_stream_t *s)
+{
+  if (s->len == 0)
+    return;
+  TlmFrame (TLM_STREAM + s->id, s->time, s->buf, s->len);
+  s->seq ++;
+  s->len = 0;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Haengt ein Sample an den Stream an. Ist der Rahmen voll, wird er gesendet.
+
+  \param[in,out]
+  s      Zustand vom Stream
+  \param[in]
+  values channels Werte (16 Bit)
+
+  \return
+  nichts
+
+  \par  Arbeitsweise:
+  Die Differenz zum letzten Sample wird in 16 Bit gerechnet, ein Ueberlauf\n
+  ist also egal, der Empfaenger rechnet genauso. Zig-Zag macht aus kleinen\n
+  negativen Zahlen kleine positive, danach werden 7 Bit pro Byte gesendet\n
+  (Bit 7 = es folgt noch ein Byte). Differenzen von -64..63 brauchen so\n
+  1 Byte, der schlimmste Fall sind 3 Byte pro Kanal. Mit Kopf passt auch\n
+  der schlimmste Fall bei TLM_STREAM_CHANNELS Kanaelen in einen Rahmen.\n
+  Ein voller Rahmen wird erst gesendet, wenn das naechste Sample nicht mehr\n
+  hineinpasst. Die Zeit im Rahmen ist deshalb die vom ersten Sample, sie\n
+  wird beim Oeffnen des Rahmens gemerkt.
+*****************************************************************************/
+void TlmStreamAdd (
+  tlm_stream_t *s,
+  const int *values)
+{
+  unsigned char tmp [3 * TLM_STREAM_CHANNELS];
+  unsigned char n = 0, i;
+  unsigned char key = (s->count == 0);
+  uint16_t z;
+  int16_t v;
+
+  if (key)                              // Keyframe beginnt immer einen Rahmen
+    TlmStreamFlush (s);
+
+  for (i = 0; i < s->channels; i++)
+  {
+    v = values [i];
+    if (!key)
+      v -= s->last [i];
+    s->last [i] = values [i];
+    z = ((uint16_t) v << 1) ^ (uint16_t) (v >> 15);   // Zig-Zag
+    while (z >= 0x80)                   // Varint
+    {
+      tmp [n++] = (unsigned char) z | 0x80;
+      z >>= 7;
+    }
+    tmp [n++] = (unsigned char) z;
+  }
+
+  if (s->len + n > TLM_MAX_DATA)
+    TlmStreamFlush (s);
+  if (s->len == 0)                      // Kopf vom neuen Rahmen
+  {
+    s->time = (unsigned int) Gettime (); // Rahmenzeit = erstes Sample
+    s->buf [s->len++] = (key << 7) | ((s->channels - 1) << 4) | (s->seq & 0x0F);
+  }
+  for (i = 0; i < n; i++)
+    s->buf [s->len++] = tmp [i];
+
+  if (++s->count >= s->keyint)
+    s->count = 0;
+}
@@ -26,6 +26,9 @@
   \version  V002 - 22.01.2007 - Sternthaler\n
             +++ Alle Funktionen\n
             Kommentierte Version (KEINE Funktionsaenderung)
+  \version  V003 - 17.10.2026\n
+            +++ Gettime()\n
+            timebase und count36kHz mit gesperrten Interrupts lesen
 *****************************************************************************/
 /*****************************************************************************
 *                                                                            *
@@ -56,6 +59,12 @@
   Das sind ca. 79.5 Stunden. Fuer die, die ihren Asuro also ohne Solarzellen\n
   betreiben, reicht diese Zeitangabe bevor der Accu leer ist.
 
+  \par  Hinweis:
+  timebase und count36kHz werden mit gesperrten Interrupts gelesen. Sonst\n
+  kann ein Ueberlauf von count36kHz dazwischen die Zeit um 7 ms\n
+  zurueckspringen lassen, und Differenzen wie Gettime() - start laufen\n
+  ueber (z.B. der Timeout in SerRead()).
+
   \par  Beispiel:
   (Nur zur Demonstration der Parameter/Returnwerte)
   \code
@@ -77,7 +86,15 @@
 *****************************************************************************/
 unsigned long Gettime (void)
 {
-  return ((timebase * 256) + count36kHz) / 36;
+  unsigned long base;
+  unsigned char count;
+  unsigned char sreg = SREG;
+
+  cli ();                               // Ueberlauf von count36kHz zwischen
+  base  = timebase;                     // den beiden Zugriffen verhindern
+  count = count36kHz;
+  SREG = sreg;
+  return ((base * 256) + count) / 36;
 }
 
 
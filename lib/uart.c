@@ -36,6 +36,22 @@
               unter http://www.roboternetz.de/
   \version  V005 - 14.08.2007 - m.a.r.v.i.n\n
             Magic Numbers ersetzt durch IO Register Defines
+  \version  V006 - 17.10.2026\n
+            +++ SerWrite ()\n
+            Sendet nicht mehr selber, sondern legt die Daten in einem\n
+            Ringpuffer ab, der im Interrupt SIG_UART_DATA geleert wird.\n
+            Die Warteschleife am Ende der Funktion entfaellt, der Sender wird\n
+            jetzt im Interrupt SIG_UART_TRANS nach dem letzten Zeichen\n
+            abgeschaltet.\n
+            +++ SerFlush (), SerTxPolicy (), SerTxDoneHook ()  NEU\n
+            +++ SerRead ()\n
+            Liest aus einem Empfangspuffer, der im Interrupt SIG_UART_RECV\n
+            gefuellt wird. Timeout in ms, Rueckgabe der gelesenen Zeichen.\n
+            +++ SerAvailable (), SerReadSome (), SerRxErrors ()  NEU\n
+            +++ SerBaud (), SerBaudError ()  NEU
+  \version  V007 - 17.10.2026\n
+            +++ SerBaud (), SerBaudError ()\n
+            Fehler der Baudrate ohne abgeschnittene Zwischenwerte, gerundet
 *****************************************************************************/
 /*****************************************************************************
 *                                                                            *
@@ -46,6 +62,60 @@
 *                                                                            *
 *****************************************************************************/
 #include "asuro.h"
+#include "myasuro.h"
+
+#define TX_MASK (MY_UART_TX_SIZE - 1)
+
+#if (MY_UART_TX_SIZE & TX_MASK) || (MY_UART_TX_SIZE > 128)
+  #error "MY_UART_TX_SIZE muss eine 2er Potenz <= 128 sein"
+#endif
+
+/*
+  Sendepuffer. Geschrieben wird an txhead (Hauptprogramm), gelesen an
+  txtail (Interrupt SIG_UART_DATA). txhead == txtail bedeutet leer.
+*/
+static volatile unsigned char txbuf [MY_UART_TX_SIZE];
+static volatile unsigned char txhead;
+static volatile unsigned char txtail;
+static unsigned char txpolicy = UART_TX_BLOCK;
+static void (* volatile txdone) (void);
+
+#define RX_MASK (MY_UART_RX_SIZE - 1)
+
+#if (MY_UART_RX_SIZE & RX_MASK) || (MY_UART_RX_SIZE > 128)
+  #error "MY_UART_RX_SIZE muss eine 2er Potenz <= 128 sein"
+#endif
+
+/*
+  Empfangspuffer. Geschrieben wird an rxhead (Interrupt SIG_UART_RECV),
+  gelesen an rxtail (Hauptprogramm).
+*/
+static volatile unsigned char rxbuf [MY_UART_RX_SIZE];
+static volatile unsigned char rxhead;
+static volatile unsigned char rxtail;
+static volatile unsigned int  rxoverrun;
+static volatile unsigned int  rxframe;
+static volatile unsigned char rxon;
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Sendet ein Zeichen aus dem Puffer direkt per Polling.\n
+  Wird nur benutzt, wenn die Interrupts gesperrt sind (Aufruf aus einer\n
+  Interrupt-Funktion oder vor dem sei() in Init()). Ohne diesen Notausgang\n
+  wuerden UART_TX_BLOCK und SerFlush() dann ewig warten.
+*****************************************************************************/
+static void TxPoll (void)
+{
+  while (!(UCSRA & (1<<UDRE)))
+    ;
+  UDR = txbuf [txtail];
+  txtail = (txtail + 1) & TX_MASK;
+  if (txtail == txhead)
+    UCSRB &= ~(1<<UDRIE);
+}
 
 
 
@@ -69,6 +139,19 @@
   \version  V004 - 31.07.2007 - Sternthaler\n
             + Erklaerungsversuch fuer die Warteschleife mit Bezug zum Forum
               unter http://www.roboternetz.de/
+  \version  V006 - 17.10.2026\n
+            + Daten ueber den Sendepuffer im Interrupt senden.\n
+            + Die Warteschleife entfaellt. Der Sender wird erst im Interrupt\n
+              SIG_UART_TRANS abgeschaltet, wenn auch das Schieberegister leer\n
+              ist (das war der Grund fuer die Warteschleife).
+
+  \par  Hinweis:
+  Die Funktion wartet nicht, bis die Daten gesendet sind. Sie werden nur in\n
+  den Sendepuffer (Groesse MY_UART_TX_SIZE in myasuro.h) kopiert und im\n
+  Interrupt SIG_UART_DATA Zeichen fuer Zeichen an die Hardware uebergeben.\n
+  Bei 2400 Baud dauert ein Zeichen ca. 4 ms, die das Hauptprogramm jetzt\n
+  weiterarbeiten kann. Nur wenn der Puffer voll ist, entscheidet die mit\n
+  SerTxPolicy() eingestellte Strategie, was passiert.
 
   \param[in]
   *data Zu sendende Daten
@@ -81,7 +164,7 @@
   \see
   Die Initialisierung vom Timer 2-Interrupt erfolgt in der Funktion Init().
 
-  \see SerPrint
+  \see SerPrint, SerFlush, SerTxPolicy
 
   \par  Beispiel:
   (Nur zur Demonstration der Parameter/Returnwerte)
@@ -95,32 +178,302 @@ void SerWrite (
   unsigned char *data,
   unsigned char length)
 {
-  unsigned char i = 0;
+  unsigned char next;
+  unsigned char sreg;
 
-  UCSRB = (1<<TXEN);                    // Sender einschalten
   while (length > 0)                    // so lange noch Daten da sind
   {
-    if (UCSRA & (1<<UDRE))
-    {                                   // warten, bis der Sendebuffer leer ist
-      UDR = data[i++];
-      length --;
+    next = (txhead + 1) & TX_MASK;
+    if (next == txtail)                 // Puffer voll
+    {
+      if (txpolicy == UART_TX_DROP)
+        return;                         // Rest verwerfen
+      if (txpolicy == UART_TX_OVERWRITE)
+      {
+        sreg = SREG;
+        cli ();
+        if (next == txtail)             // aeltestes Zeichen verwerfen
+          txtail = (txtail + 1) & TX_MASK;
+        SREG = sreg;
+      }
+      else
+      {
+        while (next == txtail)          // UART_TX_BLOCK: Platz abwarten
+        {
+          if (!(SREG & 0x80))           // Interrupts gesperrt: selber senden
+            TxPoll ();
+        }
+      }
+    }
+    txbuf [txhead] = *data++;
+    length --;
+
+    sreg = SREG;
+    cli ();
+    txhead = next;
+    if (!(UCSRB & (1<<TXEN)))
+    {
+      /*
+        Der Sender war aus. TXC-Flag von frueheren Uebertragungen loeschen,
+        sonst wuerde SIG_UART_TRANS sofort wieder abschalten.
+      */
+      UCSRA |= (1<<TXC);
+#if MY_UART_HALFDUPLEX
+      UCSRB &= ~((1<<RXEN) | (1<<RXCIE)); // IR: eigenes Echo nicht empfangen
+#endif
+      UCSRB |= (1<<TXEN) | (1<<TXCIE);  // Sender einschalten
+    }
+    UCSRB |= (1<<UDRIE);                // Puffer-leer Interrupt zulassen
+    SREG = sreg;
+  }
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Wartet, bis alle Zeichen aus dem Sendepuffer gesendet wurden und der\n
+  Sender abgeschaltet ist.
+
+  \param
+  keine
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Vor einem Wechsel von Senden auf Empfangen (IR-Schnittstelle) oder vor\n
+  einem Sleep-Mode sollte diese Funktion aufgerufen werden. SerRead() macht\n
+  das bereits selber.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  SerPrint ("Gute Nacht\r\n");
+  SerFlush ();
+  \endcode
+*****************************************************************************/
+void SerFlush (void)
+{
+  while (UCSRB & (1<<TXEN))
+  {
+    if (!(SREG & 0x80))                 // ohne Interrupts selber leeren
+    {
+      if (txhead != txtail)
+        TxPoll ();
+      else if (UCSRA & (1<<TXC))
+      {
+        UCSRB &= ~((1<<TXEN) | (1<<TXCIE));
+        UCSRA |= (1<<TXC);
+#if MY_UART_HALFDUPLEX
+        if (rxon)
+          UCSRB |= (1<<RXEN) | (1<<RXCIE);
+#endif
+      }
+    }
+  }
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Legt fest, was SerWrite() bei vollem Sendepuffer macht.
+
+  \param[in]
+  policy UART_TX_BLOCK     warten bis wieder Platz ist (Voreinstellung)\n
+         UART_TX_DROP      neue Zeichen verwerfen\n
+         UART_TX_OVERWRITE aelteste, noch nicht gesendete Zeichen verwerfen
+
+  \return
+  nichts
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Messwerte in der Regelschleife ausgeben, ohne jemals zu warten.
+  SerTxPolicy (UART_TX_DROP);
+  \endcode
+*****************************************************************************/
+void SerTxPolicy (
+  unsigned char policy)
+{
+  txpolicy = policy;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Meldet eine Funktion an, die aufgerufen wird, nachdem das letzte Zeichen\n
+  komplett gesendet und der Sender abgeschaltet wurde.
+
+  \param[in]
+  hook Funktion ohne Parameter, oder 0 zum Abmelden.
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Die Funktion wird im Interrupt SIG_UART_TRANS aufgerufen und muss deshalb\n
+  kurz sein.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  void fertig (void)
+  {
+    StatusLED (GREEN);
+  }
+
+  SerTxDoneHook (fertig);
+  StatusLED (RED);
+  SerPrint ("Hallo ASURO!\r\n");
+  \endcode
+*****************************************************************************/
+void SerTxDoneHook (
+  void (*hook) (void))
+{
+  txdone = hook;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Interrupt-Funktion 'Sendepuffer UDR leer'.\n
+  Uebergibt das naechste Zeichen aus dem Ringpuffer an die Hardware und sperrt\n
+  sich selbst, wenn der Puffer leer ist.
+*****************************************************************************/
+SIGNAL (SIG_UART_DATA)
+{
+  UDR = txbuf [txtail];
+  txtail = (txtail + 1) & TX_MASK;
+  if (txtail == txhead)
+    UCSRB &= ~(1<<UDRIE);
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Interrupt-Funktion 'Senden komplett'.\n
+  Das letzte Zeichen hat auch das Schieberegister verlassen. Jetzt kann der\n
+  Sender zum Strom sparen abgeschaltet werden.
+*****************************************************************************/
+SIGNAL (SIG_UART_TRANS)
+{
+  if (txhead == txtail)
+  {
+    UCSRB &= ~((1<<TXEN) | (1<<TXCIE)); // Sender ausschalten / Powersave
+#if MY_UART_HALFDUPLEX
+    if (rxon)                           // Empfaenger wieder einschalten
+      UCSRB |= (1<<RXEN) | (1<<RXCIE);
+#endif
+    if (txdone)
+      txdone ();
+  }
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Schaltet den Empfaenger samt Empfangs-Interrupt ein.\n
+  Das passiert erst beim ersten Aufruf einer der Lesefunktionen, damit\n
+  Programme ohne Empfang keinen Strom fuer den Empfaenger verbrauchen.\n
+  Im Halbduplex-Betrieb (IR) wartet der Empfaenger bis der Sender fertig ist.
+*****************************************************************************/
+static void RxStart (void)
+{
+  unsigned char sreg;
+
+  if (rxon)
+    return;
+  sreg = SREG;
+  cli ();
+  rxon = TRUE;
+#if MY_UART_HALFDUPLEX
+  if (!(UCSRB & (1<<TXEN)))
+#endif
+    UCSRB |= (1<<RXEN) | (1<<RXCIE);
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Anzahl der empfangenen und noch nicht gelesenen Zeichen.
+
+  \param
+  keine
+
+  \return
+  Anzahl Zeichen im Empfangspuffer (Bereich 0..MY_UART_RX_SIZE-1)
+
+  \par  Hinweis:
+  Der erste Aufruf schaltet den Empfaenger ein.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  unsigned char cmd;
+
+  while (1)
+  {
+    if (SerAvailable ())
+    {
+      SerReadSome (&cmd, 1);
+      tu_was (cmd);
     }
+    regeln ();                  // laeuft weiter, auch ohne Zeichen
   }
-  while (!(UCSRA & (1<<TXC)))           // abwarten, bis das letzte Zeichen 
-    ;                                   // uebertragen wurde.        
+  \endcode
+*****************************************************************************/
+unsigned char SerAvailable (void)
+{
+  RxStart ();
+  return (rxhead - rxtail) & RX_MASK;
+}
+
 
-  for (i = 0; i < 0xFE; i++)            // warten auf irgendwas; keiner weiss
-    for (length = 0; length < 0xFE; length++);  // wofuer
-  UCSRB  = 0x00;                        // Sender ausschalten / Powersave
 
-  // Als Grund fuer die doppelte for()-Schleife hatte Arexx-Henk hier
-  // http://www.roboternetz.de/phpBB2/viewtopic.php?p=182250#182250
-  // angegeben, dass das Senden 2-Stufig ueber UDR und einem internem
-  // Schieberegister funktioniert.
-  // Wuerde direkt nach dem Senden sofort die Empfangsfunktion aufgerufen,
-  // dann wird dort der Sender abgeschaltet obwohl noch Daten im internen
-  // Schieberegister vorhanden sind. Diese Daten wuerden dann nicht mehr
-  // gesendet.
+/****************************************************************************/
+/*!
+  \brief
+  Liest die bereits empfangenen Zeichen, ohne zu warten.
+
+  \param[out]
+  data Zeiger auf die einzulesenden Daten
+  \param[in]
+  length maximale Anzahl der zu lesenden Zeichen
+
+  \return
+  Anzahl der tatsaechlich gelesenen Zeichen (0..length)
+
+  \see SerAvailable, SerRead
+*****************************************************************************/
+unsigned char SerReadSome (
+  unsigned char *data,
+  unsigned char length)
+{
+  unsigned char i = 0;
+
+  RxStart ();
+  while (i < length && rxtail != rxhead)
+  {
+    data [i++] = rxbuf [rxtail];
+    rxtail = (rxtail + 1) & RX_MASK;
+  }
+  return i;
 }
 
 
@@ -135,7 +488,17 @@ void SerWrite (
   Der Aufrufer bestimmt ueber den Parameter Timeout, ob diese Funktion im\n
   'blocking'- oder im 'nonblocking'-Mode laufen soll. Im 'blocking'-Mode\n
   bleibt diese Funktion auf alle Faelle so lange aktiv, bis die, uber den\n
-  Parameter length, geforderte Anzahl Zeichen empfamgen wurde.
+  Parameter length, geforderte Anzahl Zeichen empfamgen wurde.\n
+  Die Zeichen werden im Interrupt SIG_UART_RECV in einem Ringpuffer\n
+  (Groesse MY_UART_RX_SIZE in myasuro.h) gesammelt. Es gehen also keine\n
+  Zeichen mehr verloren, die ankommen waehrend das Hauptprogramm etwas\n
+  anderes macht.
+
+  \version  V006 - 17.10.2026\n
+            + Lesen aus dem Empfangspuffer.\n
+            + timeout in Millisekunden (Gettime()) statt Schleifendurchlaeufen.\n
+            + Rueckgabe der Anzahl gelesener Zeichen. Bei einem Timeout wird\n
+              data[0] nicht mehr mit 'T' ueberschrieben.
 
   \param[out]
   data Zeiger auf die einzulesenden Daten
@@ -143,68 +506,269 @@ void SerWrite (
   length Anzahl der zu lesenden Zeichen
   \param[in]
   timeout 0 = blockierender Mode\n
-          Wird hier ein Wert groesser 0 uebergeben, wird nur eine gewisse Zeit\n
-          lang versucht ein weiteres Zeichen ueber die Schnittstelle zu empfangen.\n
-          Kommt in dieser Zeit kein weiteres Zeichen, wird im zurueckgegeben\n
-          Parameter date das erste Zeichen auf 'T' gesetzt und die Funktion\n
-          kehrt zum Aufrufer zurueck.\n
+          Wird hier ein Wert groesser 0 uebergeben, wird hoechstens so viele\n
+          Millisekunden auf das jeweils naechste Zeichen gewartet.\n
+          Kommt in dieser Zeit kein weiteres Zeichen, kehrt die Funktion zum\n
+          Aufrufer zurueck.\n
           Ansonsten wird die Funktion auf alle Faelle verlassen, wenn die als\n
           Parameter length geforderte Anzahl Zeichen empfangen werden konnten.
 
   \return
-  nichts
+  Anzahl der empfangenen Zeichen. Ist sie kleiner als length, ist ein\n
+  Timeout aufgetreten.
+
+  \see SerAvailable, SerReadSome, SerRxErrors
 
   \par  Beispiel:
   (Nur zur Demonstration der Parameter/Returnwerte)
   \code
-  // Empfangen von 5 Zeichen. Aber spaetestens nach 20 Versuchen wieder
-  // im Programm weiter machen.
+  // Empfangen von 5 Zeichen. Aber spaetestens nach 20 ms ohne neues
+  // Zeichen im Programm weiter machen.
   char emfangene_daten [10];
 
-  SerRead (emfangene_daten, 5, 20);
-  if (emfangene_daten [0] == 'T')
-    SerWrite ("Mist, timeout", 13);
+  if (SerRead (emfangene_daten, 5, 20) < 5)
+    SerPrint ("Mist, timeout");
   else
-    SerWrite ("5 Zeichen empfangen", 19);
+    SerPrint ("5 Zeichen empfangen");
   \endcode
 *****************************************************************************/
-void SerRead (
+unsigned char SerRead (
   unsigned char *data,
   unsigned char length,
   unsigned int timeout)
 {
   unsigned char i = 0;
-  unsigned int  time = 0;
+  unsigned long start;
 
-  UCSRB = (1<<RXEN);                         // Empfaenger einschalten
+  RxStart ();
+#if MY_UART_HALFDUPLEX
+  SerFlush ();                          // Empfaenger erst nach dem Senden an
+#endif
 
-  if (timeout != 0)
+  start = Gettime ();
+  while (i < length)
   {
-    /*
-      Die Funktion wird auf alle Faelle, auch ohne empfangene Daten, wieder
-      verlassen. --> nonblocking mode
-    */
-    while (i < length && time++ < timeout)
+    if (rxtail != rxhead)
     {
-      if (UCSRA & (1<<RXC))
-      {
-        data [i++] = UDR;
-        time = 0;
-      }
+      data [i++] = rxbuf [rxtail];
+      rxtail = (rxtail + 1) & RX_MASK;
+      start = Gettime ();               // Timeout gilt je Zeichen
     }
-    if (time > timeout)
-      data [0] = 'T';
+    else if (timeout != 0 && Gettime () - start >= timeout)
+      break;                            // nonblocking mode: Timeout
+  }
+  return i;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert die Fehlerzaehler vom Empfang.
+
+  \param[out]
+  overrun Anzahl verlorener Zeichen, weil der Empfangspuffer voll war\n
+          oder die Hardware (DOR) ueberlaufen ist.
+  \param[out]
+  frame   Anzahl Zeichen mit falschem Stopbit (FE). Diese Zeichen werden\n
+          verworfen.
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Die Zaehler bleiben bei 0xFFFF stehen.
+*****************************************************************************/
+void SerRxErrors (
+  unsigned int *overrun,
+  unsigned int *frame)
+{
+  unsigned char sreg = SREG;
+
+  cli ();
+  *overrun = rxoverrun;
+  *frame   = rxframe;
+  SREG = sreg;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Interrupt-Funktion 'Zeichen empfangen'.\n
+  Legt das Zeichen im Empfangspuffer ab und zaehlt Empfangsfehler.\n
+  Die Statusbits in UCSRA muessen vor UDR gelesen werden.
+*****************************************************************************/
+SIGNAL (SIG_UART_RECV)
+{
+  unsigned char status = UCSRA;
+  unsigned char c = UDR;
+  unsigned char next;
+
+  if ((status & (1<<DOR)) && rxoverrun != 0xFFFF)
+    rxoverrun ++;
+  if (status & (1<<FE))
+  {
+    if (rxframe != 0xFFFF)
+      rxframe ++;
+    return;
+  }
+  next = (rxhead + 1) & RX_MASK;
+  if (next == rxtail)
+  {
+    if (rxoverrun != 0xFFFF)
+      rxoverrun ++;
+    return;
+  }
+  rxbuf [rxhead] = c;
+  rxhead = next;
+}
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Berechnet UBRR fuer eine Baudrate im normalen und im U2X-Mode und nimmt\n
+  den Mode mit dem kleineren Fehler.
+
+  \param[in]
+  baud gewuenschte Baudrate
+  \param[out]
+  ubrr Wert fuer UBRRH/UBRRL
+  \param[out]
+  u2x  TRUE, wenn das U2X Bit gesetzt werden muss
+
+  \return
+  Fehler der Baudrate in 1/10 Prozent, gerundet
+
+  \par  Funktionsweise:
+  Die echte Baudrate ist F_CPU / d mit d = 16 * (UBRR + 1) * baud (8 mit\n
+  U2X). Der Fehler (F_CPU - d) / d wird ohne Zwischenergebnis in Baud\n
+  gerechnet, sonst schneidet die Division schon die Baudrate ab.
+*****************************************************************************/
+static int BaudCalc (
+  unsigned long baud,
+  unsigned int *ubrr,
+  unsigned char *u2x)
+{
+  unsigned long n1 = UART_UBRR (baud);
+  unsigned long n2 = UART_UBRR_U2X (baud);
+  unsigned long d1, d2;
+  long e1, e2;
+
+  if (n1 > 4095)                        // UBRR hat nur 12 Bit
+    n1 = 4095;
+  if (n2 > 4095)
+    n2 = 4095;
+  d1 = 16UL * (n1 + 1) * baud;
+  d2 = 8UL * (n2 + 1) * baud;
+  e1 = (long) F_CPU - (long) d1;
+  e2 = (long) F_CPU - (long) d2;
+  if (labs (e2) < labs (e1))
+  {
+    *ubrr = n2;
+    *u2x = TRUE;
+    e1 = e2;
+    d1 = d2;
   }
   else
   {
-    /*
-      Die Funktion wird auf alle Faelle erst nach dem Empfang von der
-      vorgegebenen Anzahl Zeichen verlassen. blocking mode
-    */
-    while (i < length)
-    {
-      if (UCSRA & (1<<RXC))
-        data [i++] = UDR;
-    }
+    *ubrr = n1;
+    *u2x = FALSE;
   }
+  if (labs (e1) > 2000000L)             // ueber 25 %, e1 * 1000 liefe ueber
+    return (e1 < 0) ? -999 : 999;
+  e2 = (labs (e1) * 1000L + (long) (d1 >> 1)) / (long) d1;
+  return (e1 < 0) ? -(int) e2 : (int) e2;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Stellt die Baudrate der seriellen Schnittstelle ein.
+
+  Der UBRR Wert wird aus F_CPU berechnet. Das U2X Bit (doppelte\n
+  Geschwindigkeit) wird gesetzt, wenn der Fehler damit kleiner wird.\n
+  Vorher wird der Sendepuffer geleert (SerFlush()).
+
+  \param[in]
+  baud Baudrate. Der IR-Transceiver schafft nur \b 2400 Baud.\n
+       Mit Kabel an RXD/TXD sind z.B. 9600, 19200 oder 38400 Baud moeglich.
+
+  \return
+  Fehler der eingestellten Baudrate in 1/10 Prozent.\n
+  Mehr als ca. +-20 (2 %) sind fuer eine sichere Verbindung zu viel.
+
+  \see
+  Die Voreinstellung aus Init() kommt aus MY_UART_BAUD in myasuro.h.
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Kabelverbindung zum Debuggen, ca. 3800 Byte/s statt 240 Byte/s
+  if (SerBaud (38400) > 20)
+    StatusLED (RED);            // Baudrate mit 8 MHz nicht genau genug
+  \endcode
+*****************************************************************************/
+int SerBaud (
+  unsigned long baud)
+{
+  unsigned int  ubrr;
+  unsigned char u2x;
+  int err = BaudCalc (baud, &ubrr, &u2x);
+
+  SerFlush ();
+  if (u2x)
+    UCSRA |= (1<<U2X);
+  else
+    UCSRA &= ~(1<<U2X);
+  UBRRH = (unsigned char) (ubrr >> 8);  // URSEL = 0: Zugriff auf UBRRH
+  UBRRL = (unsigned char) ubrr;
+  return err;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert den Fehler, den SerBaud() fuer eine Baudrate erreichen wuerde.\n
+  Die Schnittstelle wird nicht veraendert.
+
+  \param[in]
+  baud Baudrate
+
+  \return
+  Fehler in 1/10 Prozent
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  // Fehler fuer die ueblichen Baudraten ausgeben (bei 8 MHz:
+  // 2400 = -1 (-0.08 % mit U2X), 4800..38400 = 2 (0.16 %), 57600 = 21,
+  // 115200 = -35)
+  static const long rate [] = {2400, 4800, 9600, 19200, 38400, 57600};
+  unsigned char i;
+
+  for (i = 0; i < 6; i++)
+  {
+    PrintLong (rate [i]);
+    SerPrint (": ");
+    PrintInt (SerBaudError (rate [i]));
+    SerPrint ("\r\n");
+  }
+  \endcode
+*****************************************************************************/
+int SerBaudError (
+  unsigned long baud)
+{
+  unsigned int  ubrr;
+  unsigned char u2x;
+
+  return BaudCalc (baud, &ubrr, &u2x);
 }
@@ -25,6 +25,7 @@ void InitUltrasonics(void)
 {
 	// Change Oscillator-frequency of Timer 2
 	// to 40kHz, no toggling of IO-pin:
+  AdcScanStop();              // stop the ADC sequencer
   cli();
   TCCR2  = (1 << WGM21) | (1 << CS20);
 	OCR2   = 100;              // 40kHz @8MHz crystal
@@ -55,6 +56,8 @@ void RestoreAsuro(void)
 
 	if(autoencode) {
 		EncoderInit();
+	} else {
+		AdcScanStart();          // restart the ADC sequencer
 	}
 	sei();
 	_delay_us(1);
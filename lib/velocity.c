@@ -0,0 +1,161 @@
+/****************************************************************************/
+/*!
+  \file     velocity.c
+
+  \brief    Fahrt mit Bahngeschwindigkeit (mm/s) und Drehgeschwindigkeit\n
+            (Grad/s). Umrechnung auf die Sollwerte beider Raeder fuer die\n
+            Geschwindigkeitsregelung und zurueck aus der Odometrie.
+
+  \see      MY_GO_ENC_COUNT_VALUE, MY_TURN_ENC_COUNT_VALUE in myasuro.h\n
+            CtrlSpeed() in ctrl.c, EncoderSpeedMm() in encoder_low.c
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "asuro.h"
+#include "myasuro.h"
+#include "ctrl.h"
+#include "velocity.h"
+
+/*
+  Bei einer ganzen Drehung auf der Stelle faehrt jedes Rad
+  MY_TURN_ENC_COUNT_VALUE Ticks zu MY_GO_ENC_COUNT_VALUE / 10000 mm, das
+  ist der Umfang des Kreises mit dem Radabstand als Durchmesser.
+  VEL_K:    mm/s je Rad fuer 1 Grad/s, * 65536 (0.952 * 65536)
+  VEL_KINV: Grad/s fuer 1 mm/s Unterschied zwischen den Raedern, * 65536
+            (1 / (2 * VEL_K), 0.525 * 65536)
+  Der Compiler rechnet beide Werte beim Uebersetzen aus.
+*/
+#define VEL_K     ((long) ((double) MY_TURN_ENC_COUNT_VALUE * \
+                           MY_GO_ENC_COUNT_VALUE * 65536.0 / 3600000.0 + 0.5))
+#define VEL_KINV  ((long) (3600000.0 * 65536.0 / (2.0 * \
+                           MY_TURN_ENC_COUNT_VALUE * MY_GO_ENC_COUNT_VALUE) + 0.5))
+
+
+
+/****************************************************************************/
+/*
+  \brief
+  Begrenzt einen 32-Bit-Wert auf den Bereich von int.
+
+  \param[in]
+  x Wert
+
+  \return
+  -32767..32767
+*****************************************************************************/
+static int VelClamp (
+  long x)
+{
+  if (x > 32767L)
+    return 32767;
+  if (x < -32767L)
+    return -32767;
+  return (int) x;
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Faehrt mit einer Bahn- und einer Drehgeschwindigkeit.
+
+  \param[in]
+  v Geschwindigkeit der Fahrzeugmitte in mm/s, negativ = rueckwaerts
+  \param[in]
+  omega Drehgeschwindigkeit in Grad/s, positiv = links herum
+
+  \return
+  nichts
+
+  \see
+  GetVelocity(), CtrlSpeed()
+
+  \par  Hinweis:
+  Laeuft die Geschwindigkeitsregelung noch nicht, wird CtrlInit()\n
+  aufgerufen. Die Funktion kehrt sofort zurueck und kann z.B. aus einem\n
+  eigenen Regler mit 100 Hz aufgerufen werden: je Aufruf eine 16x32-Bit-\n
+  Multiplikation, keine Division.\n
+  Drehrichtung wie pose_t.theta (links herum positiv), also umgekehrt zu\n
+  GoTurn() und MotionTurn().
+
+  \par  Funktionsweise:
+  Jedes Rad faehrt v -+ omega * Radabstand / 2. Der Radabstand ergibt\n
+  sich aus MY_TURN_ENC_COUNT_VALUE und MY_GO_ENC_COUNT_VALUE (ca. 109 mm).
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  SetVelocity (150, 0);                 // 15 cm/s geradeaus
+  Msleep (2000);
+  SetVelocity (100, 45);                // Linkskurve, Radius ca. 127 mm
+  Msleep (2000);
+  SetVelocity (0, -90);                 // auf der Stelle rechts herum
+  Msleep (1000);
+  SetVelocity (0, 0);
+  \endcode
+*****************************************************************************/
+void SetVelocity (
+  int v,
+  int omega)
+{
+  long d = ((long) omega * VEL_K + 0x8000L) >> 16;
+
+  if (!CtrlActive ())
+    CtrlInit ();
+  CtrlSpeed (VelClamp ((long) v - d), VelClamp ((long) v + d));
+}
+
+
+
+/****************************************************************************/
+/*!
+  \brief
+  Liefert die gemessene Bahn- und Drehgeschwindigkeit.
+
+  \param[out]
+  v Geschwindigkeit der Fahrzeugmitte in mm/s
+  \param[out]
+  omega Drehgeschwindigkeit in Grad/s, positiv = links herum
+
+  \return
+  nichts
+
+  \par  Hinweis:
+  Die Radgeschwindigkeiten kommen aus EncoderSpeedMm(). Laeuft die\n
+  Geschwindigkeitsregelung, rechnet sie diese in jedem Takt neu aus,\n
+  sonst wird hier EncoderSpeedUpdate() aufgerufen (dann muss die\n
+  Odometrie mit EncoderInit() laufen).
+
+  \par  Beispiel:
+  (Nur zur Demonstration der Parameter/Returnwerte)
+  \code
+  int v, w;
+
+  SetVelocity (100, 30);
+  Msleep (1000);
+  GetVelocity (&v, &w);                 // ca. 100 und 30
+  \endcode
+*****************************************************************************/
+void GetVelocity (
+  int *v,
+  int *omega)
+{
+  long l, r;
+
+  if (!CtrlActive ())
+    EncoderSpeedUpdate ();
+  l = EncoderSpeedMm (LEFT);
+  r = EncoderSpeedMm (RIGHT);
+  *v     = (int) ((l + r) / 2);
+  *omega = VelClamp (((r - l) * VEL_KINV + 0x8000L) >> 16);
+}
@@ -24,7 +24,7 @@
 #define SPEED  0x8F
 
 int speedLeft,speedRight;
-unsigned int lineData[2];
+int lineData[2];
 int ADOffset;
 
 void LineLeft (void)
@@ -45,16 +45,21 @@ void LineDemo(void)
   unsigned char j;
 
   Init();
+  AdcOversample(IR_LEFT, 1);    // 4 Messpaare je Wert, Rauschen / 2
+  AdcOversample(IR_RIGHT, 1);
+  LineCompensation(ON);         // FrontLED an/aus, Fremdlicht faellt heraus
+  SwitchInit();                 // PollSwitch() ohne Wartezeit
 
   SerPrint("LineDemo\r\n");
-  FrontLED(ON);
-  for (j = 0; j < 0xFF; j++) LineData(lineData);
-  LineData(lineData);
+  for (j = 0; j < 8; j++)
+    while (!LineDataComp(lineData))
+      ;
   ADOffset = lineData[0] - lineData[1];
   speedLeft = speedRight = SPEED;
   for (;;)
   {
-    LineData(lineData);
+    while (!LineDataComp(lineData))
+      ;                         // auf neue Werte aus dem Sequencer warten
     i = (lineData[0] - lineData[1]) - ADOffset;
     if ( i > 4)
     {
@@ -73,7 +78,10 @@ void LineDemo(void)
     }
     MotorSpeed(speedLeft,speedRight);
     if (PollSwitch())
+    {
+      LineCompensation(OFF);
       return;
+    }
   }
 }
 
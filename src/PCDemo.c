@@ -124,7 +124,7 @@ void PCDemo(void)
   for (;;)
   {
     cmd = 0;
-    SerRead(&cmd,1,0xFFFE);
+    SerRead(&cmd,1,20);
     switch (cmd)
     {
     case RWD_KEY :
@@ -10,6 +10,8 @@
 * 1.00	   14.08.2003   Jan Grewe		 build
 * 2.00     22.10.2003   Jan Grewe    angepasst auf asuro.c Ver.2.10
 * 2.70     06.04.2007   m.a.r.v.i.n  angepat an AsuroLib V2.7.0 
+* 2.71     17.10.2026                Ecken ohne Halt (MotionBlend),
+*                                    300 mm/s wie vorher Go(200) / Turn(90,200)
 *
 * Copyright (c) 2003 DLR Robotics & Mechatronics
 *****************************************************************************/
@@ -21,6 +23,8 @@
  *   any later version.                                                    *
  ***************************************************************************/
 #include "asuro.h"
+#include "myasuro.h"
+#include "motion.h"
 
 #define LEFT 0
 #define RIGHT 1
@@ -100,11 +104,14 @@ void RechteckDemo(void)
   EncoderInit();
 
   SerPrint("RechteckDemo\r\n");
+  MotionBlend(100);           // Ecken als Bogen, ohne anzuhalten
   for(i=0; i<4; i++)
   {	  
-    Go(200, 200);
-    Turn(90,200);
+    MotionGo(200, 300);       // 300 mm/s, etwa Go(200, 200)
+    MotionTurn(90,300);
   }
+  MotionWait();
+  MotionBlend(MY_MOTION_BLEND); // Voreinstellung fuer andere Programme
   return;	  
 }
 
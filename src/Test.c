@@ -34,9 +34,11 @@ void SerialTest(void)
   for (i = 0; i < 0xFE; i++)
   {
     StatusLED(GREEN);
-    SerRead(&data,1,0xFFFE);
+    if (SerRead(&data,1,100))
+      data += 1;
+    else
+      data = 'T';
     StatusLED(RED);
-    if (data != 'T') data += 1;
     SerWrite(&data,1);
   }
 }
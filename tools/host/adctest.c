@@ -0,0 +1,209 @@
+/****************************************************************************/
+/*!
+  \file     adctest.c
+
+  \brief    PC Test fuer den ADC Sequencer (SIGNAL (SIG_ADC) in asuro.c).\n
+            Der Test spielt den AD-Wandler: er liefert fuer den Kanal in\n
+            ADMUX einen verrauschten Messwert und ruft den Interrupt auf.\n
+            - Oversampling (AdcOversample()): effektive Bits fuer n = 0..3\n
+              bei gleichverteiltem Eingang und 1 LSB Rauschen.\n
+            - Fremdlichtkompensation (LineCompensation()): Fehler von\n
+              LineDataComp() bei wechselndem Fremdlicht.\n
+            - Taster-Kanal: Ladezeit nach SWITCH_ON bis zur Messung, mit\n
+              und ohne autoencode.
+
+  \par      Aufruf:
+  \code
+  cd tools
+  make check
+  \endcode
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            Ladezeit vom Taster-Kanal
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "host.h"
+#include "../../lib/globals.c"
+#include "../../lib/asuro.c"
+#include "../../lib/adc.c"
+
+/* Ersatz fuer Funktionen, die asuro.c und adc.c aufrufen */
+void FrontLED (unsigned char status)
+{
+  PORTD = (PORTD & ~FRONT_LED) | (status ? FRONT_LED : 0);
+}
+void BackLED (unsigned char left, unsigned char right) { (void) left; (void) right; }
+void StatusLED (unsigned char color) { (void) color; }
+void MotorDir (unsigned char l, unsigned char r) { (void) l; (void) r; }
+void MotorSpeed (unsigned char l, unsigned char r) { (void) l; (void) r; }
+void Sleep (unsigned char t) { (void) t; }
+
+static double level [ADC_CHANNELS];     /* Eingang in LSB je Kanal */
+static double ledgain [ADC_CHANNELS];   /* Anteil der FrontLED in LSB */
+static double noise = 1.0;              /* Rauschen in LSB */
+static int    fail;                     /* Anzahl Fehler */
+static int    charged;                  /* Wandlungen seit SWITCH_ON */
+
+/* eine Wandlung auf dem Kanal aus ADMUX, danach der Interrupt */
+static void Convert (void)
+{
+  unsigned char ch = ADMUX & 0x07;
+  double x = level [ch] + HostGauss (noise);
+  int v;
+
+  if (PORTD & FRONT_LED)
+    x += ledgain [ch];
+  if (ch == (SWITCH) && !(PORTD & SWITCHES))
+    x = 1023;                           /* Kondensator nicht geladen */
+  charged = (PORTD & SWITCHES) ? charged + 1 : 0;
+  v = (int) floor (x + 0.5);
+  v = (v < 0) ? 0 : (v > 1023) ? 1023 : v;
+  ADCL = v & 0xFF;
+  ADCH = v >> 8;
+  ADCSRA &= ~(1 << ADSC);               /* Wandlung fertig */
+  SIG_ADC ();
+}
+
+/* Sequencer neu starten, eine noch laufende Wandlung gilt als fertig */
+static void ScanStart (
+  const unsigned char *list,
+  unsigned char n)
+{
+  ADCSRA &= ~(1 << ADSC);
+  autoencode = FALSE;
+  SWITCH_OFF;
+  AdcScanList (list, n);
+  AdcScanStart ();
+}
+
+static void TestOversample (void)
+{
+  const unsigned char list [] = {IR_LEFT};
+  unsigned char n, seq;
+  int i;
+
+  ScanStart (list, 1);
+  printf ("Oversampling, Eingang 20..1000 LSB, Rauschen %.1f LSB:\n", noise);
+  for (n = 0; n <= ADC_OSR_MAX; n++)
+  {
+    double sum = 0, e, bits;
+
+    for (i = 0; i < 20000; i++)
+    {
+      level [IR_LEFT] = HostRand (20.0, 1000.0);
+      AdcOversample (IR_LEFT, n);       /* alte Summe verwerfen */
+      seq = adcseq [IR_LEFT];
+      while (adcseq [IR_LEFT] == seq)
+        Convert ();
+      e = AdcValueExt (IR_LEFT) / (double) (1 << n) - level [IR_LEFT];
+      sum += e * e;
+    }
+    e = sqrt (sum / i);
+    bits = log2 (1024.0 / (e * sqrt (12.0)));
+    printf ("  n = %d (%2d Messungen): Fehler %.3f LSB rms, %.1f Bit%s\n",
+            n, 1 << (2 * n), e, bits, (bits < 8.0 + n) ? "  FEHLER" : "");
+    fail += bits < 8.0 + n;             /* je Stufe 1 Bit mehr */
+  }
+}
+
+static void TestLineComp (void)
+{
+  const unsigned char list [] = {IR_LEFT, IR_RIGHT};
+  unsigned char n;
+  int i, data [2], pairs;
+
+  ScanStart (list, 2);
+  ledgain [IR_LEFT]  = 300.0;
+  ledgain [IR_RIGHT] = 150.0;
+  printf ("Fremdlichtkompensation, FrontLED +300/+150 LSB,"
+          " Fremdlicht 0..600 LSB:\n");
+  for (n = 0; n <= 2; n++)
+  {
+    double maxe = 0, sum = 0;
+
+    AdcOversample (IR_LEFT, n);
+    AdcOversample (IR_RIGHT, n);
+    LineCompensation (ON);
+    pairs = 0;
+    for (i = 0; i < 400000; i++)
+    {
+      /* Fremdlicht schwankt langsam (z.B. Lampe, Schatten) */
+      level [IR_LEFT]  = 300.0 + 300.0 * sin (i * 2e-4);
+      level [IR_RIGHT] = 300.0 - 300.0 * sin (i * 3e-4);
+      Convert ();
+      if (LineDataComp (data))
+      {
+        double el = fabs (data [0] - ledgain [IR_LEFT]);
+        double er = fabs (data [1] - ledgain [IR_RIGHT]);
+
+        if (el > maxe) maxe = el;
+        if (er > maxe) maxe = er;
+        sum += el * el + er * er;
+        pairs ++;
+      }
+    }
+    LineCompensation (OFF);
+    for (i = 0; i < 100; i++)           // Sequencer laeuft ohne Kompensation
+      Convert ();                       // weiter
+    printf ("  n = %d: %5d Werte, Fehler %.2f LSB rms, max. %.1f LSB%s\n",
+            n, pairs, sqrt (sum / (2 * pairs)), maxe,
+            (maxe > 10.0) ? "  FEHLER" : "");
+    fail += maxe > 10.0;                /* 1 LSB Rauschen, 50000 Paare */
+  }
+}
+
+/*
+  Der Kondensator am Taster-Kanal laedt ab SWITCH_ON. Gemessen wird die
+  Zeit in Wandlungen (je ca. 104 us) bis zum Start der Messwandlung. Vorher
+  wartete PollSwitch() mit Sleep (10) 278 us.
+*/
+static void TestSwitch (void)
+{
+  const unsigned char list [] = {IR_LEFT, SWITCH, BATTERIE};
+  unsigned char seq, enc;
+  int i, n, min, max;
+
+  printf ("Taster-Kanal, Ladezeit vor der Messung (mind. 278 us):\n");
+  for (enc = 0; enc <= 1; enc++)
+  {
+    ScanStart (list, 3);
+    autoencode = enc;
+    min = 1000;
+    max = 0;
+    for (i = 0; i < 100; i++)
+    {
+      seq = adcseq [SWITCH];
+      n = 0;
+      while (adcseq [SWITCH] == seq)
+      {
+        n = charged;                    /* vor der letzten Wandlung */
+        Convert ();
+      }
+      if (n < min) min = n;
+      if (n > max) max = n;
+    }
+    printf ("  autoencode %-3s: %d..%d Wandlungen, %d us%s\n",
+            enc ? "an" : "aus", min, max, min * 104,
+            (min * 104 < 278) ? "  FEHLER" : "");
+    fail += min * 104 < 278;
+  }
+  autoencode = FALSE;
+}
+
+int main (void)
+{
+  srand (1);
+  TestOversample ();
+  TestLineComp ();
+  TestSwitch ();
+  return fail != 0;
+}
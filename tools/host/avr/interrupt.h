@@ -0,0 +1,14 @@
+/*
+  PC-Ersatz fuer <avr/interrupt.h>: Interrupt-Funktionen werden normale
+  Funktionen (z.B. SIG_ADC ()), die der Test selbst aufruft.
+*/
+#ifndef HOST_AVR_INTERRUPT_H
+#define HOST_AVR_INTERRUPT_H
+
+#define SIGNAL(v)    void v (void); void v (void)
+#define INTERRUPT(v) void v (void); void v (void)
+#define ISR(v)       void v (void); void v (void)
+#define sei()
+#define cli()
+
+#endif /* HOST_AVR_INTERRUPT_H */
@@ -0,0 +1,35 @@
+/*
+  PC-Ersatz fuer <avr/io.h>: die benutzten Register des ATmega8 als
+  Variablen (definiert in regs.c) und die Bitnummern.
+*/
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+#include <stdint.h>
+
+#define R8(n)  extern volatile uint8_t n;
+#define R16(n) extern volatile uint16_t n;
+#include "../regs.h"
+#undef R8
+#undef R16
+
+enum { PB0, PB1, PB2, PB3, PB4, PB5, PB6, PB7 };
+enum { PC0, PC1, PC2, PC3, PC4, PC5 };
+enum { PD0, PD1, PD2, PD3, PD4, PD5, PD6, PD7 };
+enum { WGM20 = 6, WGM21 = 3, COM20 = 4, COM21 = 5, CS20 = 0, CS21 = 1, CS22 = 2,
+       TOIE2 = 6, TOIE0 = 0, OCIE2 = 7, TOIE1 = 2, TOV0 = 0 };
+enum { RXC = 7, TXC = 6, UDRE = 5, FE = 4, DOR = 3, PE = 2, U2X = 1,
+       RXCIE = 7, TXCIE = 6, UDRIE = 5, RXEN = 4, TXEN = 3,
+       URSEL = 7, UCSZ1 = 2, UCSZ0 = 1 };
+enum { WGM10 = 0, WGM11 = 1, COM1A1 = 7, COM1B1 = 5, COM1A0 = 6, COM1B0 = 4,
+       CS10 = 0, CS11 = 1, CS12 = 2, WGM12 = 3, WGM13 = 4,
+       CS00 = 0, CS01 = 1, CS02 = 2 };
+enum { ADEN = 7, ADSC = 6, ADFR = 5, ADIF = 4, ADIE = 3,
+       ADPS2 = 2, ADPS1 = 1, ADPS0 = 0,
+       REFS1 = 7, REFS0 = 6, ADLAR = 5, MUX3 = 3, MUX2 = 2, MUX1 = 1, MUX0 = 0 };
+enum { INT1 = 7, INT0 = 6, ISC11 = 3, ISC10 = 2, ACIS1 = 1, ACI = 4, ACME = 3 };
+
+#define _BV(b)           (1 << (b))
+#define bit_is_set(r, b) ((r) & _BV (b))
+
+#endif /* HOST_AVR_IO_H */
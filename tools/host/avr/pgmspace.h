@@ -0,0 +1,16 @@
+/*
+  PC-Ersatz fuer <avr/pgmspace.h>: Flash-Tabellen liegen im RAM.
+  pgm_read_word() liest 16 Bit Little Endian wie der AVR.
+*/
+#ifndef HOST_AVR_PGMSPACE_H
+#define HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(s)            s
+#define pgm_read_byte(a)   (*(const uint8_t *) (a))
+#define pgm_read_word(a)   ((uint16_t) (((const uint8_t *) (a)) [0] | \
+                                        ((const uint8_t *) (a)) [1] << 8))
+
+#endif /* HOST_AVR_PGMSPACE_H */
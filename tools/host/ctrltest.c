@@ -0,0 +1,169 @@
+/****************************************************************************/
+/*!
+  \file     ctrltest.c
+
+  \brief    PC Test fuer die Geschwindigkeitsregelung CtrlTick() in ctrl.c.\n
+            Jedes Rad ist eine Strecke erster Ordnung: ab der Anlauf-PWM\n
+            MY_CTRL_FF_OFFSET steigt die Endgeschwindigkeit um\n
+            256 / MY_CTRL_FF_GAIN mm/s je PWM-Schritt (Nenn-Verstaerkung,\n
+            passt zur Vorsteuerung), die Zeitkonstante ist 60 ms.\n
+            Das Rad erzeugt Ticks wie in speedtest.c, gemessen wird mit dem\n
+            echten EncoderSpeedUpdate(), CtrlTick() laeuft alle 8 ms.\n
+            Ausgegeben werden Anstiegszeit (10..90 %), Ueberschwingen und\n
+            bleibende Abweichung nach Sollwertspruengen aus dem Stand, mit\n
+            den Standard Verstaerkungen MY_CTRL_KP/KI/KD bei 0.7-, 1- und\n
+            1.4-facher Streckenverstaerkung. Bei Nenn-Verstaerkung darf\n
+            das Ueberschwingen hoechstens 20 % sein, die Abweichung nach\n
+            1.5 s hoechstens 3 %.\n
+            Das Ueberschwingen kommt vor allem vom Messfenster\n
+            MY_ENC_SPEED_WINDOW: der Regler sieht die Geschwindigkeit von\n
+            vor 20..60 ms. Die Vorsteuerung allein liefe bei Nenn-\n
+            Verstaerkung ohne Ueberschwingen auf den Sollwert.
+
+  \par      Aufruf:
+  \code
+  cd tools
+  make check
+  \endcode
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "host.h"
+#include "../../lib/globals.c"
+#include "../../lib/encoder_low.c"
+#include "../../lib/ctrl.c"
+
+/* Ausgabe des Reglers, Rest wie in speedtest.c */
+static unsigned int  outpwm [2];
+static unsigned char outdir [2];
+
+void AdcScanStart (void) { }
+void MotorSlewTick (void) { }
+void MotorSlewSet (unsigned int step) { (void) step; }
+void MotorSpeed (unsigned char l, unsigned char r) { outpwm [LEFT] = l * 257U; outpwm [RIGHT] = r * 257U; }
+void MotorSpeed16 (unsigned int l, unsigned int r) { outpwm [LEFT] = l; outpwm [RIGHT] = r; }
+void MotorDir (unsigned char l, unsigned char r)
+{
+  PORTD = (PORTD & ~(FWD | RWD)) | l;
+  PORTB = (PORTB & ~(FWD | RWD)) | r;
+  outdir [LEFT]  = l;
+  outdir [RIGHT] = r;
+}
+
+#define T36_ADC     15                  /* Abtastung eines Rades in 1/36 ms */
+#define T36_TICK    (36000L / CTRL_HZ)  /* Regeltakt */
+#define MM_TICK     (MY_GO_ENC_COUNT_VALUE / 10000.0)
+#define TAU         0.060               /* Zeitkonstante der Raeder in s */
+
+static unsigned long now36;             /* Simulationszeit in 1/36 ms */
+static int           fail;              /* Anzahl Fehler */
+
+/* Zeit in timebase/count36kHz schreiben wie SIG_OVERFLOW2 */
+static void SetTime (unsigned long t)
+{
+  now36 = t;
+  timebase   = t >> 8;
+  count36kHz = t & 0xFF;
+}
+
+/*
+  Sprung aus dem Stand auf v mm/s, Strecke mit gain-facher
+  Nenn-Verstaerkung. Rad links, rechts steht.
+*/
+static void Step (
+  double gain,
+  int v,
+  double *rise,
+  double *over,
+  double *err)
+{
+  double speed = 0, pos = 0, pwm, vss, t, t10 = -1, t90 = -1, top = 0;
+  double sum = 0;
+  unsigned long t36, end = 2 * 36000L;
+  int n = 0;
+
+  CtrlInit ();
+  CtrlSpeed (v, 0);
+  for (t36 = 0; t36 < end; t36++)
+  {
+    SetTime (now36 + 1);
+    if (t36 % T36_TICK == 0)
+      CtrlTick ();
+
+    /*
+      Strecke: Endgeschwindigkeit aus der PWM ueber der Anlauf-PWM
+    */
+    pwm = (outdir [LEFT] == FWD) ? outpwm [LEFT] / 257.0 : 0.0;
+    vss = (pwm > MY_CTRL_FF_OFFSET) ?
+          gain * (pwm - MY_CTRL_FF_OFFSET) * 256.0 / MY_CTRL_FF_GAIN : 0.0;
+    speed += (vss - speed) / (TAU * 36000.0);
+    pos += speed / 36000.0;
+
+    if (t36 % T36_ADC == 0 && pos >= MM_TICK)
+    {
+      pos -= MM_TICK;
+      enctick [LEFT] ++;
+      enctime [LEFT] = ((unsigned int) timebase << 8) | count36kHz;
+    }
+
+    t = t36 / 36000.0;
+    if (t10 < 0 && speed >= 0.1 * v)
+      t10 = t;
+    if (t90 < 0 && speed >= 0.9 * v)
+      t90 = t;
+    if (speed > top)
+      top = speed;
+    if (t36 >= end - 18000L)            /* letzte 0.5 s */
+    {
+      sum += speed;
+      n ++;
+    }
+  }
+  *rise = (t90 >= 0) ? (t90 - t10) * 1000.0 : -1;
+  *over = (top > v) ? 100.0 * (top - v) / v : 0;
+  *err  = 100.0 * (sum / n - v) / v;
+
+  CtrlStop ();
+  for (t36 = 0; t36 < 36000L; t36 += T36_TICK) /* Rad steht, Messung auf 0 */
+  {
+    SetTime (now36 + T36_TICK);
+    EncoderSpeedUpdate ();
+  }
+}
+
+static void TestStep (void)
+{
+  static const double gain [] = {0.7, 1.0, 1.4};
+  static const int    speed [] = {100, 200};
+  double rise, over, err;
+  unsigned int i, k;
+  int bad;
+
+  printf ("Sollwertsprung aus dem Stand, KP %d, KI %d, KD %d, Tau %.0f ms:\n",
+          MY_CTRL_KP, MY_CTRL_KI, MY_CTRL_KD, TAU * 1000);
+  printf ("  Strecke  Sprung    Anstieg  Ueberschwingen  Abweichung\n");
+  for (i = 0; i < sizeof (gain) / sizeof (gain [0]); i++)
+    for (k = 0; k < sizeof (speed) / sizeof (speed [0]); k++)
+    {
+      Step (gain [i], speed [k], &rise, &over, &err);
+      bad = gain [i] == 1.0 && (over > 20.0 || fabs (err) > 3.0 || rise < 0);
+      printf ("  %5.1fx  %3d mm/s  %5.0f ms  %12.1f %%  %+8.1f %%%s\n",
+              gain [i], speed [k], rise, over, err, bad ? "  FEHLER" : "");
+      fail += bad;
+    }
+}
+
+int main (void)
+{
+  TestStep ();
+  return fail != 0;
+}
@@ -0,0 +1,233 @@
+/****************************************************************************/
+/*!
+  \file     fixtest.c
+
+  \brief    PC Test fuer die Festkomma-Funktionen in fixmath.c.\n
+            Vergleicht FixSin(), FixCos() und FixAtan2() ueber den ganzen\n
+            Winkelbereich, ISqrt() exakt und Fix8/Fix16 Mul/Div/Sqrt mit\n
+            Zufallswerten gegen double. Ergebnisse ausserhalb des\n
+            Wertebereichs muessen auf +-32767 bzw. +-0x7FFFFFFF begrenzt\n
+            werden.
+
+  \par      Aufruf:
+  \code
+  cd tools
+  make check
+  \endcode
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "host.h"
+#include "../../lib/fixmath.c"
+
+static int fail;                        /* Anzahl Fehler */
+
+/* Ergebnis ausgeben, Fehler zaehlen */
+static void Result (
+  const char *name,
+  double err,
+  double limit,
+  const char *unit,
+  int bad)
+{
+  printf ("  %-9s max. %7.3f %s", name, err, unit);
+  if (bad)
+    printf (", %d falsch begrenzt", bad);
+  if (err > limit || bad)
+  {
+    printf ("  FEHLER (Grenze %.3f)", limit);
+    fail ++;
+  }
+  printf ("\n");
+}
+
+/* 32 Zufallsbits, um 0..shift Bit nach rechts verschoben */
+static int32_t Rand32 (
+  int shift)
+{
+  int32_t x = (int32_t) (((uint32_t) rand () << 16) ^ (uint32_t) rand ());
+
+  return x >> (rand () % (shift + 1));
+}
+
+/* Winkelfehler in FIX_ANGLE-Einheiten, 65536 = 360 Grad */
+static double AngleErr (
+  int y,
+  int x)
+{
+  double r = atan2 (y, x) * 65536.0 / (2 * M_PI), e;
+
+  if (r < 0)
+    r += 65536.0;
+  e = fabs ((double) FixAtan2 (y, x) - r);
+  return (e > 32768.0) ? 65536.0 - e : e;
+}
+
+static void TestAngle (void)
+{
+  double e, m;
+  int32_t i, x, y;
+
+  m = 0;
+  for (i = 0; i < 65536; i++)
+  {
+    e = fabs (FixSin (i) - 32767.0 * sin (i * 2 * M_PI / 65536.0));
+    if (e > m) m = e;
+  }
+  Result ("FixSin", m, 4.0, "LSB", 0);
+
+  m = 0;
+  for (i = 0; i < 65536; i++)
+  {
+    e = fabs (FixCos (i) - 32767.0 * cos (i * 2 * M_PI / 65536.0));
+    if (e > m) m = e;
+  }
+  Result ("FixCos", m, 4.0, "LSB", 0);
+
+  m = 0;
+  for (i = 0; i < 2000000; i++)
+  {
+    x = rand () % 65535 - 32767;
+    y = rand () % 65535 - 32767;
+    if (x || y)
+    {
+      e = AngleErr (y, x);
+      if (e > m) m = e;
+    }
+  }
+  for (x = -300; x <= 300; x++)         /* kleine Werte, z.B. Pose in mm */
+    for (y = -300; y <= 300; y++)
+      if (x || y)
+      {
+        e = AngleErr (y, x);
+        if (e > m) m = e;
+      }
+  Result ("FixAtan2", m * 360.0 / 65536.0, 0.02, "Grad", 0);
+}
+
+static void TestSqrt (void)
+{
+  uint32_t x, r;
+  int32_t  i;
+  int      bad = 0;
+  double   e, m;
+
+  for (i = 0; i < 5000000; i++)
+  {
+    x = (i < 100000) ? (uint32_t) i : (uint32_t) Rand32 (31);
+    r = ISqrt (x);
+    if ((uint64_t) r * r > x || (uint64_t) (r + 1) * (r + 1) <= x)
+      bad ++;
+  }
+  if (ISqrt (0xFFFFFFFFUL) != 65535)
+    bad ++;
+  printf ("  %-9s %d von 5000001 falsch%s\n", "ISqrt", bad, bad ? "  FEHLER" : "");
+  fail += bad != 0;
+
+  m = 0;
+  for (i = 1; i < 32768; i++)
+  {
+    e = fabs (Fix8Sqrt (i) - sqrt (i / 256.0) * 256.0);
+    if (e > m) m = e;
+  }
+  Result ("Fix8Sqrt", m, 1.0, "LSB", 0);
+}
+
+static void TestFix8 (void)
+{
+  int16_t a, b;
+  double  r, e, m;
+  int32_t i, f;
+  int     bad;
+
+  m = 0;
+  bad = 0;
+  for (i = 0; i < 2000000; i++)
+  {
+    a = (int16_t) (rand () % 65535 - 32767);
+    b = (int16_t) (rand () % 65535 - 32767);
+    r = a * (double) b / 256.0;
+    f = Fix8Mul (a, b);
+    if (fabs (r) > 32767.0)
+      bad += f != ((r < 0) ? -32767 : 32767);
+    else if ((e = fabs (f - r)) > m)
+      m = e;
+  }
+  Result ("Fix8Mul", m, 0.5, "LSB", bad);
+
+  m = 0;
+  bad = 0;
+  for (i = 0; i < 2000000; i++)
+  {
+    a = (int16_t) (rand () % 65535 - 32767);
+    b = (int16_t) (rand () % 65535 - 32767);
+    if (!b)
+      continue;
+    r = a * 256.0 / b;
+    f = Fix8Div (a, b);
+    if (fabs (r) > 32767.0)
+      bad += f != ((r < 0) ? -32767 : 32767);
+    else if ((e = fabs (f - r)) > m)
+      m = e;
+  }
+  Result ("Fix8Div", m, 0.5, "LSB", bad);
+}
+
+static void TestFix16 (void)
+{
+  int32_t a, b, f, i;
+  double  r, e, m;
+  int     bad;
+
+  m = 0;
+  bad = 0;
+  for (i = 0; i < 5000000; i++)
+  {
+    a = Rand32 (23);
+    b = Rand32 (23);
+    r = (double) a * b / 65536.0;
+    f = Fix16Mul (a, b);
+    if (fabs (r) > 2147483647.0)
+      bad += f != ((r < 0) ? -0x7FFFFFFF : 0x7FFFFFFF);
+    else if ((e = fabs (f - r)) > m)
+      m = e;
+  }
+  Result ("Fix16Mul", m, 1.0, "LSB", bad);
+
+  m = 0;
+  bad = 0;
+  for (i = 0; i < 5000000; i++)
+  {
+    a = Rand32 (23);
+    b = Rand32 (30);
+    if (!b)
+      continue;
+    r = (double) a * 65536.0 / b;
+    f = Fix16Div (a, b);
+    if (fabs (r) > 2147483647.0)
+      bad += f != ((r < 0) ? -0x7FFFFFFF : 0x7FFFFFFF);
+    else if ((e = fabs (f - r)) > m)
+      m = e;
+  }
+  Result ("Fix16Div", m, 1.0, "LSB", bad);
+}
+
+int main (void)
+{
+  srand (1);
+  printf ("Festkomma gegen double:\n");
+  TestAngle ();
+  TestSqrt ();
+  TestFix8 ();
+  TestFix16 ();
+  return fail != 0;
+}
@@ -0,0 +1,40 @@
+/*
+  Gemeinsamer Kopf der PC-Tests in tools/host.
+
+  Die Tests binden die Quellen aus lib/ direkt ein, damit sie immer den
+  aktuellen Stand pruefen. Vorher werden hier alle Systemheader geladen und
+  long auf 32 Bit gebracht wie beim AVR. int bleibt auf dem PC 32 Bit,
+  Ueberlaeufe von 16-Bit-Rechnungen findet der Test also nicht.
+  Konstanten mit L-Suffix rechnet der PC weiter mit 64 Bit.
+*/
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define long int                        /* 32 Bit wie beim AVR */
+
+/* gleichverteilte Zufallszahl a..b */
+static inline double HostRand (double a, double b)
+{
+  return a + (b - a) * rand () / (double) RAND_MAX;
+}
+
+/* normalverteilte Zufallszahl (Box-Muller), Mittelwert 0 */
+static inline double HostGauss (double sigma)
+{
+  double u = (rand () + 1.0) / ((double) RAND_MAX + 2.0);
+  double v = rand () / ((double) RAND_MAX + 1.0);
+
+  return sigma * sqrt (-2.0 * log (u)) * cos (2.0 * M_PI * v);
+}
+
+#endif /* HOST_H */
@@ -0,0 +1,634 @@
+/****************************************************************************/
+/*!
+  \file     motiontest.c
+
+  \brief    PC Test fuer die Warteschlange in motion.c mit der echten\n
+            Geschwindigkeitsregelung (ctrl.c) an einem Fahrzeug mit zwei\n
+            Raedern.\n
+            Jedes Rad ist eine Strecke erster Ordnung wie in ctrltest.c,\n
+            aber mit zufaelliger Verstaerkung 0.92..1.0 und Zeitkonstante\n
+            30..80 ms je Rad und Lauf. Ticks (MY_GO_ENC_COUNT_VALUE) kommen\n
+            im Takt der ADC-Abtastung, die Richtung wie in asuro.c aus den\n
+            Richtungsbits von MotorDir(). Die Lage des Fahrzeugs wird aus\n
+            den Radwegen integriert, der Radabstand passt zu\n
+            MY_TURN_ENC_COUNT_VALUE.\n
+            Quadrat mit 200 mm Kantenlaenge bei 200 mm/s, 50 Laeufe:\n
+            - GoTurn() blockierend (nach jedem Abschnitt warten)\n
+            - alle Abschnitte in der Warteschlange, ohne Abrunden\n
+            - MotionBlend (70) und MotionBlend (100)\n
+            Gemessen werden Fahrzeit bis zur leeren Warteschlange, Abstand\n
+            vom Startpunkt nach dem Auslaufen und die groesste Abweichung\n
+            von der Bahn (Mittelwerte). Fehler, wenn Zeit oder Abstand einer\n
+            Zeile ueber der Grenze liegt (Messung beim Einbau des Tests plus\n
+            etwa 2 %).\n
+            Kreisbogen R 200 mm um 90 Grad rechts herum gegen\n
+            Turn (45) + Go (283) + Turn (45), jeweils mit MY_MOTION_KSYNC 8\n
+            und 0 (ohne Gleichlauf). Mit Gleichlauf muss der Bogen genauer\n
+            ankommen als ohne und als Drehung - Gerade - Drehung, Abstand\n
+            und Richtung am Ziel sind begrenzt.\n
+            Die Korrektur selbst wird mit festen Ticks direkt an\n
+            MotionTick() geprueft: Begrenzung auf vmax / 4 fuer beide\n
+            Vorzeichen und kein Umdrehen des inneren Rades eines Bogens.\n
+            Trapezprofil je Regeltakt fuer Gerade, Bogen und Drehung:\n
+            mit Raedern, die dem Sollwert sofort folgen, muss das Profil\n
+            vmax erreichen (die kurze Gerade die aus Beschleunigung und\n
+            Laenge erwartete Spitze), sich je Takt um hoechstens\n
+            MY_MOTION_ACCEL / CTRL_HZ aendern und vor dem Ende bei\n
+            MY_MOTION_VMIN ankommen, ohne lange zu kriechen. Mit der\n
+            Strecke darf der groesste PWM-Schritt hoechstens halb so gross\n
+            sein wie ohne Profil (MotionAccel (0)).\n
+            RechteckDemo (MotionBlend (100), 300 mm/s) gegen das alte\n
+            blockierende GoTurn() mit Msleep (200) nach jedem Abschnitt\n
+            und gegen GoTurn() ohne Pause: die Warteschlange muss am\n
+            schnellsten sein und hoechstens 4400 ms brauchen.
+
+  \par      Aufruf:
+  \code
+  cd tools
+  make check
+  \endcode
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            Gleichlauf: Viertelkreis mit KSYNC 8 und 0, Korrektur in\n
+            MotionTick() mit festen Ticks
+  \version  V003 - 17.10.2026\n
+            Trapezprofil: Spitze, Ende bei MY_MOTION_VMIN, Aenderung je\n
+            Takt und PWM-Schritt. Grenzen des Quadrats neu gemessen, das\n
+            Profil bremst jetzt bis MY_MOTION_VMIN
+  \version  V004 - 17.10.2026\n
+            Zeit des RechteckDemo gegen das alte GoTurn()
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "host.h"
+#include "../../lib/globals.c"
+#include "../../lib/fixmath.c"
+#include "../../lib/encoder_low.c"
+#include "../../lib/ctrl.c"
+
+/* Gleichlauf im Test umschaltbar */
+enum { KSYNC = MY_MOTION_KSYNC };     /* Wert aus myasuro.h */
+static int ksync = KSYNC;
+#undef  MY_MOTION_KSYNC
+#define MY_MOTION_KSYNC ksync
+#include "../../lib/motion.c"
+
+/* Ausgabe des Reglers, Rest wie in ctrltest.c */
+static unsigned int  outpwm [2];
+static unsigned char outdir [2];
+
+void AdcScanStart (void) { }
+void MotorSlewTick (void) { }
+void MotorSlewSet (unsigned int step) { (void) step; }
+void MotorSpeed (unsigned char l, unsigned char r) { outpwm [LEFT] = l * 257U; outpwm [RIGHT] = r * 257U; }
+void MotorSpeed16 (unsigned int l, unsigned int r) { outpwm [LEFT] = l; outpwm [RIGHT] = r; }
+void MotorDir (unsigned char l, unsigned char r)
+{
+  PORTD = (PORTD & ~(FWD | RWD)) | l;
+  PORTB = (PORTB & ~(FWD | RWD)) | r;
+  outdir [LEFT]  = l;
+  outdir [RIGHT] = r;
+}
+
+#define T36_ADC     15                  /* Abtastung eines Rades in 1/36 ms */
+#define T36_TICK    (36000L / CTRL_HZ)  /* Regeltakt */
+#define MM_TICK     (MY_GO_ENC_COUNT_VALUE / 10000.0)
+#define TRACK       (MY_TURN_ENC_COUNT_VALUE * MM_TICK / M_PI)  /* Radabstand mm */
+#define RUNS        50                  /* Laeufe mit verschiedenen Raedern */
+#define SIDE        200                 /* Kantenlaenge mm */
+#define SPEED       200                 /* mm/s */
+
+static unsigned long now36;             /* Simulationszeit in 1/36 ms */
+static int           fail;              /* Anzahl Fehler */
+static int           ideal;             /* Raeder folgen dem Sollwert sofort */
+
+/* Zustand der Raeder und des Fahrzeugs */
+static struct
+{
+  double gain [2], tau [2];             /* Strecke je Rad */
+  double speed [2];                     /* mm/s */
+  double pos [2];                       /* Weg seit dem letzten Tick mm */
+  int    dir [2];                       /* Zaehlrichtung wie encdir in asuro.c */
+  double x, y, th;                      /* Lage, th gegen den Uhrzeigersinn */
+} car;
+
+/* Zeit in timebase/count36kHz schreiben wie SIG_OVERFLOW2 */
+static void SetTime (unsigned long t)
+{
+  now36 = t;
+  timebase   = t >> 8;
+  count36kHz = t & 0xFF;
+}
+
+/* Neue Raeder, Fahrzeug im Ursprung mit Richtung +x */
+static void Reset (void)
+{
+  unsigned char side;
+
+  MotionCancel ();
+  CtrlStop ();
+  for (side = LEFT; side <= RIGHT; side++)
+  {
+    car.gain [side]  = HostRand (0.92, 1.0);
+    car.tau [side]   = HostRand (0.030, 0.080);
+    car.speed [side] = 0;
+    car.pos [side]   = 0;
+    car.dir [side]   = 1;
+  }
+  car.x = car.y = car.th = 0;
+  MotionInit ();
+}
+
+/* Eine 1/36 ms weiter: Regeltakt, Raeder, Ticks und Lage */
+static void Step (void)
+{
+  unsigned char side;
+  double pwm, vss, ds [2];
+
+  SetTime (now36 + 1);
+  if (now36 % T36_TICK == 0)
+    CtrlTick ();
+
+  for (side = LEFT; side <= RIGHT; side++)
+  {
+    pwm = outpwm [side] / 257.0;
+    vss = (pwm > MY_CTRL_FF_OFFSET) ?
+          car.gain [side] * (pwm - MY_CTRL_FF_OFFSET) * 256.0 / MY_CTRL_FF_GAIN : 0.0;
+    if (outdir [side] == RWD)
+      vss = -vss;
+    else if (outdir [side] != FWD)
+      vss = 0;
+    car.speed [side] += (vss - car.speed [side]) / (car.tau [side] * 36000.0);
+    if (ideal)
+      car.speed [side] = target [side];
+    ds [side] = car.speed [side] / 36000.0;
+    car.pos [side] += fabs (ds [side]);
+
+    if (ideal ? target [side] > 0 : outdir [side] == FWD)
+      car.dir [side] = 1;
+    else if (ideal ? target [side] < 0 : outdir [side] == RWD)
+      car.dir [side] = -1;
+    if (now36 % T36_ADC == 0 && car.pos [side] >= MM_TICK)
+    {
+      car.pos [side] -= MM_TICK;
+      enctick [side] += car.dir [side];
+      enctime [side] = ((unsigned int) timebase << 8) | count36kHz;
+    }
+  }
+  car.x  += (ds [LEFT] + ds [RIGHT]) / 2 * cos (car.th);
+  car.y  += (ds [LEFT] + ds [RIGHT]) / 2 * sin (car.th);
+  car.th += (ds [RIGHT] - ds [LEFT]) / TRACK;
+}
+
+/* Abstand des Punktes x, y von der Strecke ax, ay - bx, by */
+static double SegDist (
+  double x, double y,
+  double ax, double ay,
+  double bx, double by)
+{
+  double dx = bx - ax, dy = by - ay;
+  double u = ((x - ax) * dx + (y - ay) * dy) / (dx * dx + dy * dy);
+
+  u = (u < 0) ? 0 : (u > 1) ? 1 : u;
+  return hypot (x - ax - u * dx, y - ay - u * dy);
+}
+
+/* Abstand von der Bahn des Quadrats (rechts herum ab dem Ursprung) */
+static double SquareDist (double x, double y)
+{
+  double d, m;
+
+  m = SegDist (x, y, 0, 0, SIDE, 0);
+  if ((d = SegDist (x, y, SIDE, 0, SIDE, -SIDE)) < m) m = d;
+  if ((d = SegDist (x, y, SIDE, -SIDE, 0, -SIDE)) < m) m = d;
+  if ((d = SegDist (x, y, 0, -SIDE, 0, 0)) < m) m = d;
+  return m;
+}
+
+/*
+  Laeuft, bis die Warteschlange leer ist (wie MotionWait(), das auf dem
+  PC nie zurueckkaeme). Merkt sich die groesste Abweichung vom Quadrat.
+*/
+static void Run (double *dev)
+{
+  double d;
+
+  while (MotionBusy ())
+  {
+    Step ();
+    if (dev && (d = SquareDist (car.x, car.y)) > *dev)
+      *dev = d;
+  }
+}
+
+/* Raeder auslaufen lassen, dann ist die Lage am Ende fest */
+static void Settle (void)
+{
+  unsigned long t;
+
+  for (t = 0; t < 36000L; t++)
+    Step ();
+}
+
+/*
+  Quadrat mit speed mm/s, blockierend (wait) oder ganz in der
+  Warteschlange, mit Eckenradius radius. Blockierend wird nach jedem
+  Abschnitt noch pause ms gewartet. Ergebnisse als Mittelwerte ueber alle
+  Laeufe.
+*/
+static void Square (
+  int wait,
+  int radius,
+  int speed,
+  int pause,
+  double *time,
+  double *err,
+  double *dev)
+{
+  unsigned long t0, t;
+  int i, k;
+
+  srand (1);
+  for (k = 0; k < RUNS; k++)
+  {
+    double d = 0;
+
+    Reset ();
+    MotionBlend (radius);
+    t0 = now36;
+    for (i = 0; i < 4; i++)
+    {
+      MotionGo (SIDE, speed);
+      if (wait)
+        for (Run (&d), t = 0; t < pause * 36L; t++)
+          Step ();
+      MotionTurn (90, speed);
+      if (wait)
+        for (Run (&d), t = 0; t < pause * 36L; t++)
+          Step ();
+    }
+    Run (&d);
+    *time += (now36 - t0) / 36.0;
+    Settle ();
+    *err += hypot (car.x, car.y);
+    *dev += d;
+  }
+  *time /= RUNS;
+  *err  /= RUNS;
+  *dev  /= RUNS;
+  MotionBlend (MY_MOTION_BLEND);
+}
+
+static void TestSquare (void)
+{
+  /* Grenzen fuer Zeit in ms und Abstand in mm */
+  static const struct
+  {
+    const char *name;
+    int wait, radius;
+    double time, err;
+  } row [] =
+  {
+    {"GoTurn blockierend",  1,   0, 7800,  7.5},
+    {"Warteschlange",       0,   0, 7700,  6.5},
+    {"MotionBlend (70)",    0,  70, 6500,  9.0},
+    {"MotionBlend (100)",   0, 100, 5800,  4.5},
+  };
+  double time, err, dev;
+  unsigned int i;
+  int bad;
+
+  printf ("Quadrat %d mm, %d mm/s, %d Laeufe (Mittelwerte):\n",
+          SIDE, SPEED, RUNS);
+  printf ("                       Zeit      Ende     Bahn\n");
+  for (i = 0; i < sizeof (row) / sizeof (row [0]); i++)
+  {
+    time = err = dev = 0;
+    Square (row [i].wait, row [i].radius, SPEED, 0, &time, &err, &dev);
+    bad = time > row [i].time || err > row [i].err;
+    printf ("  %-18s  %5.0f ms  %4.1f mm  %4.1f mm%s\n",
+            row [i].name, time, err, dev, bad ? "  FEHLER" : "");
+    fail += bad;
+  }
+}
+
+/*
+  RechteckDemo: 4 * (MotionGo (200, 300) + MotionTurn (90, 300)) mit
+  MotionBlend (100) gegen das alte GoTurn(): Go (200, 200) und
+  Turn (90, 200) sind nach der Vorsteuerung 300 mm/s, jeder Abschnitt
+  blockierend und danach Msleep (200). Der alte Gleichlauf ueber die PWM
+  ist hier durch den Regler ersetzt, die Zeit der Fahrt selbst ist etwa
+  gleich.
+*/
+static void TestDemo (void)
+{
+  static const struct
+  {
+    const char *name;
+    int wait, radius, pause;
+  } row [] =
+  {
+    {"GoTurn alt, Msleep 200", 1,   0, 200},
+    {"GoTurn blockierend",     1,   0,   0},
+    {"RechteckDemo",           0, 100,   0},
+  };
+  double time [3], err, dev;
+  unsigned int i;
+  int bad;
+
+  printf ("RechteckDemo, Quadrat %d mm, 300 mm/s, %d Laeufe (Mittelwerte):\n",
+          SIDE, RUNS);
+  for (i = 0; i < sizeof (row) / sizeof (row [0]); i++)
+  {
+    time [i] = err = dev = 0;
+    Square (row [i].wait, row [i].radius, 300, row [i].pause, &time [i], &err, &dev);
+    printf ("  %-22s  %5.0f ms  %4.1f mm\n", row [i].name, time [i], err);
+  }
+  bad = time [2] >= time [1] || time [1] >= time [0] || time [2] > 4400;
+  printf ("  Warteschlange schneller als blockierend: %s (%.0f %% der alten Zeit)\n",
+          bad ? "nein  FEHLER" : "ja", 100 * time [2] / time [0]);
+  fail += bad;
+}
+
+/*
+  Viertelkreis R 200 mm rechts herum als Bogen (arc) oder als
+  Drehung - Gerade - Drehung. Liefert Abstand vom Ziel und Fehler der
+  Richtung, Mittelwert und groessten Wert ueber alle Laeufe.
+*/
+static void Quarter (
+  int arc,
+  double *err,
+  double *errmax,
+  double *head,
+  double *headmax)
+{
+  double e, h;
+  int k;
+
+  srand (2);
+  *err = *errmax = *head = *headmax = 0;
+  for (k = 0; k < RUNS; k++)
+  {
+    Reset ();
+    if (arc)
+      MotionArc (200, 90, SPEED);
+    else
+    {
+      MotionTurn (45, SPEED);
+      MotionGo (283, SPEED);
+      MotionTurn (45, SPEED);
+    }
+    Run (NULL);
+    Settle ();
+    e = hypot (car.x - 200, car.y + 200);
+    h = fabs (car.th + M_PI / 2) * 180 / M_PI;
+    *err  += e;
+    *head += h;
+    if (e > *errmax) *errmax = e;
+    if (h > *headmax) *headmax = h;
+  }
+  *err  /= RUNS;
+  *head /= RUNS;
+}
+
+static void TestArc (void)
+{
+  double err [2][2], errmax, head, headmax;
+  int arc, i, bad;
+
+  printf ("Viertelkreis R 200 mm, %d mm/s, %d Laeufe, Abstand / Richtung\n"
+          "am Ziel (Mittelwert / groesster Wert):\n", SPEED, RUNS);
+  for (i = 0; i < 2; i++)
+  {
+    ksync = i ? 0 : KSYNC;
+    for (arc = 1; arc >= 0; arc--)
+    {
+      Quarter (arc, &err [i][arc], &errmax, &head, &headmax);
+      bad = i == 0 && arc && (err [i][arc] > 4.0 || head > 1.5);
+      printf ("  %-20s KSYNC %d  %5.1f / %5.1f mm  %4.1f / %4.1f Grad%s\n",
+              arc ? "Bogen" : "Drehung-Gerade-Dreh.", ksync,
+              err [i][arc], errmax, head, headmax, bad ? "  FEHLER" : "");
+      fail += bad;
+    }
+  }
+  ksync = KSYNC;
+  bad = err [0][1] >= err [1][1];
+  printf ("  Bogen mit Gleichlauf genauer als ohne: %s\n", bad ? "nein  FEHLER" : "ja");
+  fail += bad;
+  bad = err [0][1] >= err [0][0];
+  printf ("  Bogen genauer als Drehung-Gerade-Drehung: %s\n", bad ? "nein  FEHLER" : "ja");
+  fail += bad;
+}
+
+/*
+  Eine Korrektur von MotionTick() ohne Profil (profv = vmax) nach
+  Vorlauf der Raeder um al / ar Ticks. Liefert die Sollwerte der Raeder.
+*/
+static void Sync (
+  unsigned char type,
+  int value,
+  int radius,
+  int al,
+  int ar,
+  int *wl,
+  int *wr)
+{
+  Reset ();
+  MotionAccel (0);
+  if (type == MOTION_GO)
+    MotionGo (value, SPEED);
+  else if (type == MOTION_TURN)
+    MotionTurn (value, SPEED);
+  else
+    MotionArc (radius, value, SPEED);
+  MotionTick ();                        /* Abschnitt laden */
+  enctick [LEFT]  += al;
+  enctick [RIGHT] += ar;
+  MotionTick ();
+  *wl = wheel [LEFT];
+  *wr = wheel [RIGHT];
+  MotionCancel ();
+  MotionAccel (MY_MOTION_ACCEL);
+}
+
+static void TestSync (void)
+{
+  static const struct
+  {
+    const char   *name;
+    unsigned char type;
+    int           value, radius, al, ar;
+    int           wl, wr;               /* erwartet */
+  } row [] =
+  {
+    {"Gerade, gleich",              MOTION_GO,    500,   0,   0,   0, SPEED,            SPEED},
+    {"Gerade, links 4 voraus",      MOTION_GO,    500,   0,   4,   0, SPEED - 2 * KSYNC, SPEED + 2 * KSYNC},
+    {"Gerade, links 20 voraus",     MOTION_GO,    500,   0,  20,   0, SPEED - SPEED / 4, SPEED + SPEED / 4},
+    {"Gerade, rechts 20 voraus",    MOTION_GO,    500,   0,   0,  20, SPEED + SPEED / 4, SPEED - SPEED / 4},
+    {"Drehung, rechts 20 voraus",   MOTION_TURN,  180,   0,   0, -20, SPEED + SPEED / 4, -SPEED + SPEED / 4},
+    {"Drehung, links 20 voraus",    MOTION_TURN, -180,   0, -20,   0, -SPEED + SPEED / 4, SPEED + SPEED / 4},
+  };
+  unsigned int i;
+  int wl, wr, bad;
+
+  printf ("Gleichlauf in MotionTick(), KSYNC %d, %d mm/s, Sollwerte links / rechts:\n",
+          ksync, SPEED);
+  for (i = 0; i < sizeof (row) / sizeof (row [0]); i++)
+  {
+    Sync (row [i].type, row [i].value, row [i].radius, row [i].al, row [i].ar, &wl, &wr);
+    bad = wl != row [i].wl || wr != row [i].wr;
+    printf ("  %-28s %4d / %4d mm/s%s\n", row [i].name, wl, wr, bad ? "  FEHLER" : "");
+    fail += bad;
+  }
+
+  /*
+    Enger Bogen R 80: das innere Rad hat 20 von 108 Ticks, also 37 mm/s.
+    Eilt es 10 Ticks vor, wird es auf 0 gebremst statt rueckwaerts
+    gedreht, das aeussere bekommt die volle Korrektur.
+  */
+  Sync (MOTION_ARC, 90, 80, 0, 10, &wl, &wr);
+  bad = wl != SPEED + SPEED / 4 || wr != 0;
+  printf ("  %-28s %4d / %4d mm/s%s\n", "Bogen R 80, innen 10 voraus", wl, wr,
+          bad ? "  FEHLER" : "");
+  fail += bad;
+  Sync (MOTION_ARC, -90, 80, 10, 0, &wl, &wr);
+  bad = wl != 0 || wr != SPEED + SPEED / 4;
+  printf ("  %-28s %4d / %4d mm/s%s\n", "Bogen R 80 links, innen vor.", wl, wr,
+          bad ? "  FEHLER" : "");
+  fail += bad;
+}
+
+/*
+  Ein Abschnitt mit Raedern, die dem Sollwert sofort folgen (ideal) oder
+  der Strecke. Liefert das Profil je Regeltakt: hoechster Wert, letzter
+  Wert vor dem Ende, Zeit bei MY_MOTION_VMIN nach dem Anfahren in ms und
+  groesste Aenderung (mm/s * 256), dazu den groessten PWM-Schritt und
+  die erste PWM.
+*/
+static void Profile (
+  unsigned char type,
+  int value,
+  int radius,
+  int speed,
+  double *top,
+  double *last,
+  double *crawl,
+  double *dvmax,
+  double *pwmstep,
+  double *pwmfirst)
+{
+  long old = 0;
+  double pwm, pwmold = 0;
+  unsigned char side;
+
+  srand (3);
+  Reset ();
+  *top = *last = *crawl = *dvmax = *pwmstep = 0;
+  *pwmfirst = -1;
+  if (type == MOTION_GO)
+    MotionGo (value, speed);
+  else if (type == MOTION_TURN)
+    MotionTurn (value, speed);
+  else
+    MotionArc (radius, value, speed);
+  while (MotionBusy ())
+  {
+    Step ();
+    if (now36 % T36_TICK || !MotionBusy ())
+      continue;
+    if ((profv >> 8) > *top)
+      *top = profv >> 8;
+    *last = profv / 256.0;
+    if (*top > MY_MOTION_VMIN && profv <= ((long) MY_MOTION_VMIN << 8))
+      *crawl += 1000.0 / CTRL_HZ;
+    if (labs (profv - old) > *dvmax)
+      *dvmax = labs (profv - old);
+    old = profv;
+
+    for (side = LEFT, pwm = 0; side <= RIGHT; side++)
+      if (outpwm [side] / 257.0 > pwm)
+        pwm = outpwm [side] / 257.0;
+    if (*pwmfirst < 0)
+      *pwmfirst = pwm;
+    if (fabs (pwm - pwmold) > *pwmstep)
+      *pwmstep = fabs (pwm - pwmold);
+    pwmold = pwm;
+  }
+  Settle ();
+}
+
+static void TestProfile (void)
+{
+  /*
+    peak: erwartete Spitze, 0 = vmax. Die Gerade 100 mm ist zu kurz fuer
+    300 mm/s: Anfahren von 0 und Bremsen auf MY_MOTION_VMIN treffen sich
+    bei v^2 = a * Laenge + VMIN^2 / 2, die Abzuege in MotionTick()
+    kosten etwas davon.
+  */
+  static const struct
+  {
+    const char   *name;
+    unsigned char type;
+    int           value, radius, speed;
+    double        peak;
+  } row [] =
+  {
+    {"Gerade 500 mm",       MOTION_GO,   500,   0, 300, 0},
+    {"Bogen R 200, 90 Gr.", MOTION_ARC,   90, 200, 300, 0},
+    {"Drehung 180 Grad",    MOTION_TURN, 180,   0, 200, 0},
+    {"Gerade 100 mm",       MOTION_GO,   100,   0, 300, 283.6},
+  };
+  double top, last, crawl, dvmax, step, first, step0, dummy, peak;
+  unsigned int i;
+  int bad;
+
+  printf ("Trapezprofil, MotionAccel (%d):\n", MY_MOTION_ACCEL);
+  printf ("  %-20s  vmax  Spitze  Ende  Kriechen  dv  PWM-Schritt  erste PWM\n", "");
+  for (i = 0; i < sizeof (row) / sizeof (row [0]); i++)
+  {
+    ideal = 1;
+    Profile (row [i].type, row [i].value, row [i].radius, row [i].speed,
+             &top, &last, &crawl, &dvmax, &dummy, &dummy);
+    ideal = 0;
+    Profile (row [i].type, row [i].value, row [i].radius, row [i].speed,
+             &dummy, &dummy, &dummy, &dummy, &step, &first);
+    MotionAccel (0);
+    Profile (row [i].type, row [i].value, row [i].radius, row [i].speed,
+             &dummy, &dummy, &dummy, &dummy, &step0, &dummy);
+    MotionAccel (MY_MOTION_ACCEL);
+
+    /*
+      Spitze wie erwartet, Ende genau bei MY_MOTION_VMIN nach hoechstens
+      5 Takten, Aenderung hoechstens dv je Takt. Mit Strecke hoechstens
+      der halbe PWM-Schritt ohne Profil, der erste Takt kaum ueber der
+      Anlauf-PWM.
+    */
+    peak = row [i].peak ? row [i].peak : row [i].speed;
+    bad = top > peak || top < 0.95 * peak ||
+          fabs (last - MY_MOTION_VMIN) > 0.5 || crawl > 5000.0 / CTRL_HZ ||
+          dvmax > ((long) MY_MOTION_ACCEL << 8) / CTRL_HZ ||
+          step > step0 / 2 || first > MY_CTRL_FF_OFFSET + 8;
+    printf ("  %-20s  %4d  %6.0f  %4.1f  %5.0f ms  %4.0f  %4.0f / %4.0f  %5.0f%s\n",
+            row [i].name, row [i].speed, top, last, crawl, dvmax, step, step0,
+            first, bad ? "  FEHLER" : "");
+    fail += bad;
+  }
+}
+
+int main (void)
+{
+  TestProfile ();
+  TestSquare ();
+  TestDemo ();
+  TestSync ();
+  TestArc ();
+  return fail != 0;
+}
@@ -0,0 +1,151 @@
+/****************************************************************************/
+/*!
+  \file     motortest.c
+
+  \brief    PC Test fuer den Ausgleich der Batteriespannung in MotorSpeed()\n
+            (motor_low.c).\n
+            motorvmv laeuft in 10 mV Schritten von 4200 bis 5600 mV, jede\n
+            Vorgabe 0..255 geht durch MotorSpeed(). Verglichen wird OCR1A\n
+            mit Vorgabe * Nennspannung / Batteriespannung in double:\n
+            - Skalierung bei pwmlimit 255 und bei einem kleineren pwmlimit\n
+            - Begrenzung des Faktors auf MOTOR_VGAIN_MIN..MOTOR_VGAIN_MAX\n
+              (0.5..1.5) bei unsinnigen Spannungen\n
+            - ohne Messwert (motorvmv 0) bleibt die Vorgabe unveraendert\n
+            - das Beispiel aus BatteryCompensate(): 150 bei 4.4 V wie 164,\n
+              bei 5.4 V wie 133.
+
+  \par      Aufruf:
+  \code
+  cd tools
+  make check
+  \endcode
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "host.h"
+#include "../../lib/globals.c"
+#include "../../lib/motor_low.c"
+
+/* inline in motor_low.c, hier als normale Funktion erzeugen */
+extern void MotorSpeed (unsigned char left_speed, unsigned char right_speed);
+
+static int fail;                        /* Anzahl Fehler */
+
+/*
+  Alle Vorgaben 0..255 bei Batteriespannung mv. Liefert die groesste
+  Abweichung von OCR1A nach oben (hi) und unten (lo) gegen
+  min (limit, s * gain), gain auf 0.5..1.5 begrenzt (0 = kein Ausgleich).
+  Zaehlt Werte ueber pwmlimit in over.
+*/
+static void Sweep (
+  unsigned int mv,
+  double *lo,
+  double *hi,
+  int *over)
+{
+  double gain = 1.0, r, e;
+  int s;
+
+  if (motorvnom && mv)
+  {
+    gain = (double) motorvnom / mv;
+    gain = (gain < 0.5) ? 0.5 : (gain > 1.5) ? 1.5 : gain;
+  }
+  motorvmv = mv;
+  for (s = 0; s <= 255; s++)
+  {
+    MotorSpeed (s, 255 - s);
+    r = s * gain;
+    if (r > pwmlimit)
+      r = pwmlimit;
+    e = (double) OCR1A - r;
+    if (e < *lo) *lo = e;
+    if (e > *hi) *hi = e;
+    *over += OCR1A > pwmlimit || OCR1B > pwmlimit;
+  }
+}
+
+/* Ergebnis eines Durchlaufs ausgeben, Fehler zaehlen */
+static void Result (
+  const char *name,
+  double lo,
+  double hi,
+  int over)
+{
+  /*
+    Faktor (1/256) und PWM werden abgeschnitten, die Vorgabe ist mit 257
+    statt 256 gestreckt (255 -> 65535): etwas mehr als 1 LSB je Richtung
+  */
+  int bad = lo < -1.25 || hi > 1.25 || over;
+
+  printf ("  %-28s %+5.2f..%+5.2f LSB", name, lo, hi);
+  if (over)
+    printf (", %d ueber pwmlimit", over);
+  printf ("%s\n", bad ? "  FEHLER" : "");
+  fail += bad;
+}
+
+static void TestVgain (void)
+{
+  static const unsigned int odd [] = {1000, 2000, 3199, 3200, 9600, 9601, 20000, 65535};
+  static const unsigned char limit [] = {255, 180};
+  double lo, hi;
+  unsigned int mv, i;
+  int over;
+
+  motorvnom = MY_BATTERY_NOMINAL;
+  printf ("MotorSpeed() mit Ausgleich auf %u mV, OCR1A gegen double:\n",
+          motorvnom);
+  for (i = 0; i < sizeof (limit); i++)
+  {
+    char name [40];
+
+    pwmlimit = limit [i];
+    lo = hi = 0;
+    over = 0;
+    for (mv = 4200; mv <= 5600; mv += 10)
+      Sweep (mv, &lo, &hi, &over);
+    sprintf (name, "4200..5600 mV, pwmlimit %u:", pwmlimit);
+    Result (name, lo, hi, over);
+  }
+
+  pwmlimit = 255;
+  lo = hi = 0;
+  over = 0;
+  for (i = 0; i < sizeof (odd) / sizeof (odd [0]); i++)
+    Sweep (odd [i], &lo, &hi, &over);
+  Result ("Faktor 0.5..1.5 begrenzt:", lo, hi, over);
+
+  lo = hi = 0;
+  over = 0;
+  Sweep (0, &lo, &hi, &over);           /* noch kein Messwert */
+  motorvnom = 0;
+  Sweep (5000, &lo, &hi, &over);        /* BatteryCompensate (0) */
+  Result ("ohne Ausgleich:", lo, hi, over);
+
+  motorvnom = MY_BATTERY_NOMINAL;
+  motorvmv  = 4400;
+  MotorSpeed (150, 150);
+  lo = OCR1A;
+  motorvmv  = 5400;
+  MotorSpeed (150, 150);
+  hi = OCR1A;
+  printf ("  MotorSpeed (150, 150): 4.4 V -> %.0f, 5.4 V -> %.0f%s\n", lo, hi,
+          (fabs (lo - 164) > 1 || fabs (hi - 133) > 1) ? "  FEHLER" : "");
+  fail += fabs (lo - 164) > 1 || fabs (hi - 133) > 1;
+}
+
+int main (void)
+{
+  TestVgain ();
+  return fail != 0;
+}
@@ -0,0 +1,327 @@
+/****************************************************************************/
+/*!
+  \file     odotest.c
+
+  \brief    PC Test fuer die selbstkalibrierende Odometrie\n
+            (EncoderAutoThreshold() und Huellkurven in SIGNAL (SIG_ADC)).\n
+            Der Test spielt den AD-Wandler mit zwei Encoderscheiben: jedes\n
+            Segment ist ein Tick, die Kanten sind weich (Lichtfleck), dazu\n
+            kommen Rauschen und Fremdlicht. Eine Wandlung dauert 104 us,\n
+            gemessen wird die Standard Liste aus adcscan.\n
+            - Fahrt mit Halten, Fremdlicht steigt und faellt, Kontrast\n
+              halbiert sich: encoder[] muss bei jedem Halt genau die\n
+              Segmentwechsel gezaehlt haben.\n
+            - Stillstand auf einer Kante: keine Ticks durch Rauschen, die\n
+              Huellkurven laufen unter MY_ODO_MIN_CONTRAST zusammen.\n
+            - Scheibe mit zu wenig Kontrast (unter MY_ODO_MIN_CONTRAST):\n
+              keine Ticks.\n
+            - Schaltschwellen bei 3/8 und 5/8 des Kontrastes, bei kleinem\n
+              Kontrast mindestens MY_ODO_MIN_CONTRAST / 2 um die Mitte.
+
+  \par      Aufruf:
+  \code
+  cd tools
+  make check
+  \endcode
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "host.h"
+#include "../../lib/globals.c"
+#include "../../lib/asuro.c"
+#include "../../lib/adc.c"
+#include "../../lib/encoder_low.c"
+
+/* Ersatz fuer Funktionen, die asuro.c, adc.c und encoder_low.c aufrufen */
+void FrontLED (unsigned char status) { (void) status; }
+void BackLED (unsigned char left, unsigned char right) { (void) left; (void) right; }
+void StatusLED (unsigned char color) { (void) color; }
+void MotorDir (unsigned char l, unsigned char r) { (void) l; (void) r; }
+void MotorSpeed (unsigned char l, unsigned char r) { (void) l; (void) r; }
+void Sleep (unsigned char t) { (void) t; }
+
+#define T_CONV  104e-6                  /* Dauer einer Wandlung in s */
+
+/* eine Encoderscheibe mit Sensor */
+static struct
+{
+  double pos;                           /* Stellung in Ticks */
+  double vel;                           /* Ticks/s */
+  double dark, light;                   /* Messwert dunkel/hell ohne Fremdlicht */
+  unsigned int  samples;                /* Wandlungen dieses Rades */
+} wheel [2];
+
+static double amb;                      /* Fremdlicht in LSB */
+static double noise = 2.0;              /* Rauschen in LSB */
+static int    fail;                     /* Anzahl Fehler */
+
+/*
+  Messwert eines Rades. Hell bei sin > 0, die Kante bei jeder ganzen
+  Stellung ist etwa 0.15 Ticks breit.
+*/
+static double Level (
+  int side)
+{
+  double s = tanh (4.0 * sin (M_PI * wheel [side].pos)) / tanh (4.0);
+
+  return amb + wheel [side].dark +
+         (wheel [side].light - wheel [side].dark) * (0.5 + 0.5 * s);
+}
+
+/* eine Wandlung auf dem Kanal aus ADMUX, danach der Interrupt */
+static void Convert (void)
+{
+  unsigned char ch = ADMUX & 0x07;
+  double x = 300.0;
+  int side, v;
+
+  for (side = LEFT; side <= RIGHT; side++)
+    wheel [side].pos += wheel [side].vel * T_CONV;
+  if (ch == WHEEL_LEFT || ch == WHEEL_RIGHT)
+  {
+    side = (ch == WHEEL_LEFT) ? LEFT : RIGHT;
+    x = Level (side) + HostGauss (noise);
+    wheel [side].samples ++;
+  }
+  v = (int) floor (x + 0.5);
+  v = (v < 0) ? 0 : (v > 1023) ? 1023 : v;
+  ADCL = v & 0xFF;
+  ADCH = v >> 8;
+  ADCSRA &= ~(1 << ADSC);               /* Wandlung fertig */
+  SIG_ADC ();
+}
+
+/* Sequencer mit Odometrie neu starten, Raeder im dunklen Segment 1 */
+static void Start (
+  double dl,
+  double ll,
+  double dr,
+  double lr)
+{
+  ADCSRA &= ~(1 << ADSC);
+  wheel [LEFT].dark   = dl;
+  wheel [LEFT].light  = ll;
+  wheel [RIGHT].dark  = dr;
+  wheel [RIGHT].light = lr;
+  wheel [LEFT].pos = wheel [RIGHT].pos = 1.5;
+  wheel [LEFT].vel = wheel [RIGHT].vel = 0;
+  amb = 0;
+  EncoderInit ();
+  EncoderAutoThreshold (ON);
+}
+
+static void Wait (
+  double t)
+{
+  long n;
+
+  for (n = 0; n < t / T_CONV; n++)
+    Convert ();
+}
+
+/*
+  Beide Raeder fahren ticks Segmente weiter (links mit v, rechts mit
+  0.8 v Ticks/s) und halten an. Das Fremdlicht laeuft dabei linear auf
+  amb_end.
+*/
+static void Move (
+  double ticks,
+  double v,
+  double amb_end)
+{
+  double end [2], amb0 = amb, t = 0, total = ticks / v;
+  int side, run;
+
+  end [LEFT]  = wheel [LEFT].pos + ticks;
+  end [RIGHT] = wheel [RIGHT].pos + ticks;
+  wheel [LEFT].vel  = v;
+  wheel [RIGHT].vel = 0.8 * v;
+  do
+  {
+    Convert ();
+    t += T_CONV;
+    amb = amb0 + (amb_end - amb0) * ((t < total) ? t / total : 1.0);
+    run = 0;
+    for (side = LEFT; side <= RIGHT; side++)
+    {
+      if (wheel [side].pos >= end [side])
+      {
+        wheel [side].pos = end [side];
+        wheel [side].vel = 0;
+      }
+      run += wheel [side].vel != 0;
+    }
+  } while (run);
+  amb = amb_end;
+}
+
+/* Segmentwechsel seit dem Start (Raeder beginnen bei 1.5) */
+static int Ticks (
+  int side)
+{
+  return (int) floor (wheel [side].pos) - 1;
+}
+
+/* encoder[] gegen die Segmentwechsel, Fehler zaehlen */
+static void Check (
+  const char *name)
+{
+  int bad = encoder [LEFT] != Ticks (LEFT) || encoder [RIGHT] != Ticks (RIGHT);
+
+  printf ("  %-38s links %4d/%4d, rechts %4d/%4d%s\n", name,
+          encoder [LEFT], Ticks (LEFT), encoder [RIGHT], Ticks (RIGHT),
+          bad ? "  FEHLER" : "");
+  fail += bad;
+}
+
+static void TestDrive (void)
+{
+  int l, r, bad;
+
+  printf ("Fahrt mit Halten, encoder[] / Segmentwechsel:\n");
+  Start (120.0, 300.0, 200.0, 320.0);
+  Move (200, 100.0, 0);
+  Check ("200 Ticks, 100 Ticks/s");
+  Wait (1.5);
+  Move (50, 20.0, 0);
+  Check ("1.5 s Halt, 50 Ticks, 20 Ticks/s");
+  Wait (2.0);
+  Move (300, 150.0, 250.0);
+  Check ("Fremdlicht +250 LSB, 150 Ticks/s");
+  Wait (1.0);
+  wheel [LEFT].light  = 210.0;          /* Kontrast halbiert */
+  wheel [RIGHT].light = 260.0;
+  Move (300, 60.0, 0);
+  Check ("Kontrast halbiert, Fremdlicht -250 LSB");
+
+  /*
+    Halt genau auf einer Kante: der Messwert liegt in der Mitte, nur das
+    Rauschen wechselt. Die Huellkurven laufen zusammen, dann schaltet
+    MY_ODO_MIN_CONTRAST das Zaehlen ab.
+  */
+  Move (10.5, 40.0, 0);
+  noise = 4.0;
+  l = encoder [LEFT];
+  r = encoder [RIGHT];
+  Wait (3.0);
+  l = encoder [LEFT] - l;
+  r = encoder [RIGHT] - r;
+  bad = l || r || EncoderQuality (LEFT) >= MY_ODO_MIN_CONTRAST ||
+        EncoderQuality (RIGHT) >= MY_ODO_MIN_CONTRAST;
+  printf ("  %-38s links %d, rechts %d Ticks, Kontrast %u/%u LSB%s\n",
+          "3 s Halt auf der Kante:", l, r, EncoderQuality (LEFT),
+          EncoderQuality (RIGHT), bad ? "  FEHLER" : "");
+  fail += bad;
+  noise = 2.0;
+  wheel [LEFT].pos  -= 0.5;             /* wieder Segmentmitte, wie gezaehlt */
+  wheel [RIGHT].pos -= 0.5;
+  Move (100, 80.0, 0);
+  Check ("weiter nach dem Halt:");
+  EncoderAutoThreshold (OFF);
+}
+
+static void TestLowContrast (void)
+{
+  printf ("Scheibe mit 25 LSB Kontrast (MY_ODO_MIN_CONTRAST %d):\n",
+          MY_ODO_MIN_CONTRAST);
+  noise = 1.0;
+  Start (150.0, 175.0, 150.0, 175.0);
+  Move (100, 50.0, 0);
+  printf ("  100 Segmente: links %d, rechts %d Ticks%s\n",
+          encoder [LEFT], encoder [RIGHT],
+          (encoder [LEFT] || encoder [RIGHT]) ? "  FEHLER" : "");
+  fail += encoder [LEFT] || encoder [RIGHT];
+  noise = 2.0;
+  EncoderAutoThreshold (OFF);
+}
+
+/*
+  Wandelt nur den linken Radkanal mit Messwert x (ohne Rauschen), bis er
+  einmal gemessen wurde. Liefert TRUE, wenn dabei ein Tick kam.
+*/
+static int Probe (
+  double x)
+{
+  unsigned int n = wheel [LEFT].samples;
+  int e = encoder [LEFT];
+
+  wheel [LEFT].dark = wheel [LEFT].light = x;
+  while (wheel [LEFT].samples == n)
+    Convert ();
+  return encoder [LEFT] != e;
+}
+
+/*
+  Schaltschwellen bei Kontrast dark..light: vor jedem Versuch einmal
+  hell/dunkel einlernen, dann einen Wert x zeigen. Gesucht ist der
+  kleinste x, der von dunkel nach hell schaltet, und der groesste, der von
+  hell nach dunkel schaltet.
+*/
+static void Threshold (
+  double dark,
+  double light,
+  double up_exp,
+  double down_exp)
+{
+  double x, up = -1, down = -1;
+
+  noise = 0;
+  Start (dark, light, dark, light);
+  wheel [LEFT].vel = wheel [RIGHT].vel = 0;
+  for (x = dark; x <= light && up < 0; x += 1.0)
+  {
+    Probe (light); Probe (dark);        /* einlernen, endet dunkel */
+    if (Probe (x))
+      up = x;
+    else
+      Probe (light);
+    Probe (dark);
+  }
+  for (x = light; x >= dark && down < 0; x -= 1.0)
+  {
+    Probe (dark); Probe (light);        /* einlernen, endet hell */
+    if (Probe (x))
+      down = x;
+    else
+      Probe (dark);
+    Probe (light);
+  }
+  /*
+    Die Huellkurven klingen zwischen den Versuchen etwas ab, dazu kommt
+    das Runden auf 10 Bit: 2 LSB Toleranz
+  */
+  printf ("  Kontrast %3.0f: hell ab %5.1f (soll %5.1f), dunkel ab %5.1f"
+          " (soll %5.1f)%s\n", light - dark, up, up_exp, down, down_exp,
+          (fabs (up - up_exp) > 2.0 || fabs (down - down_exp) > 2.0) ?
+          "  FEHLER" : "");
+  fail += fabs (up - up_exp) > 2.0 || fabs (down - down_exp) > 2.0;
+  noise = 2.0;
+  EncoderAutoThreshold (OFF);
+}
+
+static void TestThreshold (void)
+{
+  double half = MY_ODO_MIN_CONTRAST / 2.0;
+
+  printf ("Schaltschwellen (Hysterese 3/8..5/8, mind. +-%.0f LSB):\n", half);
+  Threshold (100.0, 300.0, 100.0 + 200.0 * 5 / 8, 100.0 + 200.0 * 3 / 8);
+  Threshold (100.0, 160.0, 130.0 + half, 130.0 - half);
+}
+
+int main (void)
+{
+  srand (1);
+  TestDrive ();
+  TestLowContrast ();
+  TestThreshold ();
+  return fail != 0;
+}
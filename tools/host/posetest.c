@@ -0,0 +1,154 @@
+/****************************************************************************/
+/*!
+  \file     posetest.c
+
+  \brief    PC Test fuer die Koppelnavigation in pose.c.\n
+            Ein Modell mit zwei Raedern faehrt 20 zufaellige Strecken aus\n
+            Geraden, Kurven und Drehungen auf der Stelle (je ca. 4 m) und\n
+            rechnet die Position in double mit 0.1 ms Schritten. Jeder\n
+            ganze Weg eines Rades von 1.9363 mm ruft enchook auf wie\n
+            SIG_ADC. Verglichen wird GetPose() am Ende jeder Strecke,\n
+            einmal mit PoseUpdate() alle 8 ms wie im Regeltakt und einmal\n
+            nach jedem Tick (wie vorher PoseTick() im Interrupt).
+
+  \par      Aufruf:
+  \code
+  cd tools
+  make check
+  \endcode
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "host.h"
+#include "../../lib/globals.c"
+#include "../../lib/fixmath.c"
+#include "../../lib/pose.c"
+
+/* Ersatz fuer Funktionen, die pose.c aufruft */
+static void (*background) (void);
+void EncoderInit (void) { autoencode = TRUE; }
+void CtrlBackground (void (*fn) (void)) { background = fn; }
+
+#define MM_TICK   (MY_GO_ENC_COUNT_VALUE / 10000.0)
+/* Radabstand: MY_TURN_ENC_COUNT_VALUE Ticks je Rad fuer 360 Grad */
+#define TRACK     (MM_TICK * MY_TURN_ENC_COUNT_VALUE / M_PI)
+
+static int fail;                        /* Anzahl Fehler */
+
+/*
+  Faehrt 20 Strecken, PoseUpdate() alle ms Millisekunden (0 = nach
+  jedem Tick).
+  Liefert den groessten Fehler in mm und Grad.
+*/
+static double Drive (
+  int ms,
+  double *path,
+  double *head)
+{
+  double worst = 0, e;
+  int run, seg, step;
+
+  srand (5);                            /* alle Laeufe gleiche Strecken */
+  *path = *head = 0;
+  for (run = 0; run < 20; run++)
+  {
+    double x = 0, y = 0, th = 0, sl = 0, sr = 0;
+    int nl = 0, nr = 0, ticks = 0;
+    pose_t p;
+
+    PoseInit ();
+    PoseSet (0, 0, 0);
+    for (seg = 0; seg < 30; seg++)
+    {
+      int    type = rand () % 3, len = 3000 + rand () % 20000;
+      double v = 50 + rand () % 250, vl, vr, t;
+
+      if (type == 0)                    /* geradeaus */
+        vl = vr = v;
+      else if (type == 1)               /* Kurve */
+      {
+        vl = v;
+        vr = v * HostRand (0.3, 1.0);
+        if (rand () & 1)
+        {
+          t = vl; vl = vr; vr = t;
+        }
+      }
+      else                              /* auf der Stelle */
+      {
+        vl = v / 2;
+        vr = -v / 2;
+        if (rand () & 1)
+        {
+          vl = -vl; vr = -vr;
+        }
+      }
+      for (step = 0; step < len; step++) /* 0.1 ms */
+      {
+        double dt = 1e-4, ds = (vl + vr) / 2 * dt, dth = (vr - vl) / TRACK * dt;
+
+        x  += ds * cos (th + dth / 2);
+        y  += ds * sin (th + dth / 2);
+        th += dth;
+        *path += fabs (ds);
+        sl += vl * dt;
+        sr += vr * dt;
+        while (sl >= (nl + 1) * MM_TICK) { nl ++; enchook (LEFT, 1); }
+        while (sl <= (nl - 1) * MM_TICK) { nl --; enchook (LEFT, -1); }
+        while (sr >= (nr + 1) * MM_TICK) { nr ++; enchook (RIGHT, 1); }
+        while (sr <= (nr - 1) * MM_TICK) { nr --; enchook (RIGHT, -1); }
+        if (ms ? step % (ms * 10) == 0 : nl + nr != ticks)
+          background ();
+        ticks = nl + nr;
+      }
+    }
+    GetPose (&p);
+    e = hypot (p.x - x, p.y - y);
+    if (e > worst)
+      worst = e;
+    e = fabs (remainder (p.theta * 2 * M_PI / 65536.0 - th, 2 * M_PI)) * 180 / M_PI;
+    if (e > *head)
+      *head = e;
+    PoseStop ();
+  }
+  return worst;
+}
+
+static void TestPose (void)
+{
+  static const int ms [] = {8, 0};
+  double path, head, pos;
+  unsigned int i;
+  int bad;
+
+  printf ("Koppelnavigation gegen double, 20 Laeufe:\n");
+  for (i = 0; i < sizeof (ms) / sizeof (ms [0]); i++)
+  {
+    pos = Drive (ms [i], &path, &head);
+    /*
+      Gezaehlt werden nur ganze Ticks: jedes Rad liegt bis zu 1.9 mm hinter
+      dem Modell, bei 109 mm Radabstand bis zu 2 Grad Richtung. Geprueft
+      wird nur der Regeltakt, jeder Tick einzeln ist der Vergleich.
+    */
+    bad = ms [i] && (pos > 10.0 || head > 2.1);
+    printf ("  PoseUpdate() %-16s %.0f m: max. %4.1f mm, %.2f Grad%s\n",
+            ms [i] ? "alle 8 ms," : "nach jedem Tick,", path / 1000, pos, head,
+            bad ? "  FEHLER" : "");
+    fail += bad;
+  }
+}
+
+int main (void)
+{
+  TestPose ();
+  return fail != 0;
+}
@@ -0,0 +1,8 @@
+/*
+  Register des ATmega8 fuer die PC-Tests (siehe avr/io.h).
+*/
+#include <stdint.h>
+
+#define R8(n)  volatile uint8_t n;
+#define R16(n) volatile uint16_t n;
+#include "regs.h"
@@ -0,0 +1,11 @@
+/*
+  Liste der nachgebildeten Register, R8 = 8 Bit, R16 = 16 Bit.
+  Wird von avr/io.h (Deklaration) und regs.c (Definition) eingebunden.
+*/
+R8 (TCCR0) R8 (TCNT0) R8 (TCCR1A) R8 (TCCR1B) R8 (TCCR2) R8 (TCNT2) R8 (OCR2)
+R8 (TIMSK) R8 (TIFR) R8 (GICR) R8 (MCUCR) R8 (SFIOR) R8 (ACSR) R8 (SREG)
+R8 (UCSRA) R8 (UCSRB) R8 (UCSRC) R8 (UBRRL) R8 (UBRRH) R8 (UDR)
+R8 (DDRB) R8 (DDRC) R8 (DDRD) R8 (PORTB) R8 (PORTC) R8 (PORTD)
+R8 (PINB) R8 (PINC) R8 (PIND)
+R8 (ADCSRA) R8 (ADMUX) R8 (ADCL) R8 (ADCH)
+R16 (OCR1A) R16 (OCR1B) R16 (ICR1) R16 (TCNT1) R16 (ADC)
@@ -0,0 +1,176 @@
+/****************************************************************************/
+/*!
+  \file     speedtest.c
+
+  \brief    PC Test fuer die Geschwindigkeitsmessung EncoderSpeedUpdate()\n
+            in encoder_low.c.\n
+            Der Test spielt Rad und ADC Sequencer: ein Rad mit 12\n
+            ungleich grossen Segmenten (+-8 %) dreht mit fester\n
+            Geschwindigkeit, jede Flanke landet mit der Abtastzeit des\n
+            Sequencers (ca. 0.4 ms) in enctick und enctime.\n
+            EncoderSpeedUpdate() laeuft alle 8 ms wie im Regeltakt.\n
+            Verglichen wird mit dem Zaehlen der Ticks je 8 ms.
+
+  \par      Aufruf:
+  \code
+  cd tools
+  make check
+  \endcode
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            Wert 100 ms nach dem Anhalten pruefen
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include "host.h"
+#include "../../lib/globals.c"
+#include "../../lib/encoder_low.c"
+
+/* Ersatz fuer Funktionen, die encoder_low.c aufruft */
+void AdcScanStart (void) { }
+
+#define T36_ADC     15                  /* Abtastung eines Rades in 1/36 ms */
+#define T36_UPDATE  (8 * 36)            /* Aufruf EncoderSpeedUpdate() */
+#define MM_TICK     (MY_GO_ENC_COUNT_VALUE / 10000.0)
+
+static unsigned long now36;             /* Simulationszeit in 1/36 ms */
+static int           fail;              /* Anzahl Fehler */
+
+/* Zeit in timebase/count36kHz schreiben wie SIG_OVERFLOW2 */
+static void SetTime (unsigned long t)
+{
+  now36 = t;
+  timebase   = t >> 8;
+  count36kHz = t & 0xFF;
+}
+
+/*
+  Faehrt t36 Zeiteinheiten mit v mm/s (0 = Stillstand) und ruft alle 8 ms
+  EncoderSpeedUpdate() auf. Ab skip werden die Fehler beider Verfahren
+  gegen v aufsummiert.
+*/
+static void Run (
+  double v,
+  unsigned long t36,
+  unsigned long skip,
+  double *mt,
+  double *count,
+  double *bias)
+{
+  static double seg [12], pos;          /* Segmente in Ticks, Radstellung */
+  static int    idx;
+  double        sum = 0;
+  unsigned long end = now36 + t36;
+  unsigned long t, next = now36 + T36_UPDATE;
+  long          last = enctick [LEFT];
+  double        tps = v / MM_TICK / 36000.0; /* Ticks je 1/36 ms */
+  double        e, sm = 0, sc = 0, sb = 0;
+  int           n = 0;
+
+  if (seg [0] == 0)
+  {
+    for (idx = 0; idx < 12; idx++)
+      sum += seg [idx] = 1.0 + HostRand (-0.08, 0.08);
+    for (idx = 0; idx < 12; idx++)      /* im Mittel genau 1 Tick */
+      seg [idx] *= 12.0 / sum;
+  }
+
+  for (t = now36; t < end; t += T36_ADC)
+  {
+    SetTime (t);
+    pos += tps * T36_ADC;
+    if (pos >= seg [idx % 12])          /* Flanke seit der letzten Abtastung */
+    {
+      pos -= seg [idx % 12];
+      idx ++;
+      enctick [LEFT] ++;
+      enctime [LEFT] = ((unsigned int) timebase << 8) | count36kHz;
+    }
+    if (t >= next)
+    {
+      next += T36_UPDATE;
+      EncoderSpeedUpdate ();
+      if (t - (end - t36) >= skip)
+      {
+        e = EncoderSpeedMm (LEFT) - v;
+        sm += e * e;
+        sb += e;
+        e = (enctick [LEFT] - last) * MM_TICK * 36000.0 / T36_UPDATE - v;
+        sc += e * e;
+        n ++;
+      }
+      last = enctick [LEFT];
+    }
+  }
+  SetTime (end);
+  if (n && v)
+  {
+    *mt    = 100.0 * sqrt (sm / n) / v;
+    *count = 100.0 * sqrt (sc / n) / v;
+    *bias  = 100.0 * sb / n / v;
+  }
+}
+
+static void TestSpeed (void)
+{
+  static const int speed [] = {5, 10, 20, 40, 80, 150, 250, 350};
+  double mt, count, bias;
+  unsigned int i;
+  int stop;
+
+  printf ("Radgeschwindigkeit, Fehler in %% (rms) nach 1 s Anlauf:\n");
+  printf ("  mm/s  Ticks/s  EncoderSpeedMm  Mittelwert  Ticks je 8 ms\n");
+  for (i = 0; i < sizeof (speed) / sizeof (speed [0]); i++)
+  {
+    Run (speed [i], 4 * 36000L, 36000L, &mt, &count, &bias);
+    /*
+      Bei wenigen Ticks je Messfenster misst EncoderSpeedUpdate() einzelne
+      Segmente, deren Groesse um +-8 % streut (4.6 % rms).
+    */
+    printf ("  %4d  %7.1f  %14.1f  %+10.1f  %13.1f%s\n",
+            speed [i], speed [i] / MM_TICK, mt, bias, count,
+            (mt > 6.0 || fabs (bias) > 2.0) ? "  FEHLER" : "");
+    fail += mt > 6.0 || fabs (bias) > 2.0;
+
+    /*
+      Anhalten: ohne neue Ticks muss der Wert fallen. Seit der letzten
+      Messflanke (hoechstens ein Messfenster vor dem Halt) gab es die
+      Ticks eines Fensters und einen angebrochenen, 100 ms nach dem Halt
+      darf es hoechstens das sein. Nach MY_ENC_SPEED_TIMEOUT ms muss 0
+      kommen.
+    */
+    Run (0, 100 * 36L, 0, &mt, &count, &bias);
+    stop = EncoderSpeedMm (LEFT);
+    if (stop > (speed [i] * MY_ENC_SPEED_WINDOW / 1000.0 + 2 * MM_TICK) * 10)
+    {
+      printf ("  nach %d mm/s: %d mm/s nach 100 ms Stillstand  FEHLER\n",
+              speed [i], stop);
+      fail ++;
+    }
+    Run (0, ENC_T36 (MY_ENC_SPEED_TIMEOUT) - 100 * 36L + 2 * T36_UPDATE, 0,
+         &mt, &count, &bias);
+    stop = EncoderSpeedMm (LEFT);
+    if (stop != 0)
+    {
+      printf ("  nach %d mm/s: %d mm/s nach %d ms Stillstand  FEHLER\n",
+              speed [i], stop, MY_ENC_SPEED_TIMEOUT + 16);
+      fail ++;
+    }
+    Run (0, 36000L, 0, &mt, &count, &bias);
+  }
+}
+
+int main (void)
+{
+  srand (1);
+  TestSpeed ();
+  return fail != 0;
+}
@@ -0,0 +1,295 @@
+/****************************************************************************/
+/*!
+  \file     tlmdecode.c
+
+  \brief    PC Programm zum Dekodieren der ASURO Telemetrie (telemetry.c).\n
+            Liest den binaeren Datenstrom von stdin oder einer Datei,\n
+            prueft jeden COBS Rahmen per CRC-8 und gibt die Datensaetze\n
+            als CSV auf stdout aus:
+
+  \code
+  zeit_ms,typ,wert1,wert2
+  \endcode
+
+            Die Zeit wird aus den 16 Bit vom ASURO ueber Ueberlaeufe hinweg\n
+            fortgezaehlt. Defekte Rahmen werden gezaehlt und am Ende auf\n
+            stderr gemeldet.\n
+            Delta-Streams (TLM_STREAM) werden wieder zu absoluten Werten\n
+            zusammengesetzt, eine Zeile pro Sample. Die Zeit vom Rahmen\n
+            gehoert zum ersten Sample, die weiteren bekommen den Abstand\n
+            der Samples im vorherigen Rahmen des Streams (Rahmenabstand /\n
+            Anzahl Samples). Nach einem verlorenen Rahmen wird bis zum\n
+            naechsten Keyframe nichts ausgegeben.
+
+  \par      Uebersetzen und Aufruf (Linux):
+  \code
+  gcc -O2 -o tlmdecode tlmdecode.c
+  stty -F /dev/ttyUSB0 2400 raw -echo
+  ./tlmdecode /dev/ttyUSB0 > messung.csv
+  \endcode
+
+  \version  V001 - 17.10.2026\n
+            Erste Implementierung
+  \version  V002 - 17.10.2026\n
+            Delta-Streams dekodieren
+  \version  V003 - 17.10.2026\n
+            Eigene Zeit fuer jedes Sample eines Stream Rahmens statt der\n
+            Rahmenzeit in jeder Zeile
+*****************************************************************************/
+/*****************************************************************************
+*                                                                            *
+*   This program is free software; you can redistribute it and/or modify     *
+*   it under the terms of the GNU General Public License as published by     *
+*   the Free Software Foundation; either version 2 of the License, or        *
+*   any later version.                                                       *
+*                                                                            *
+*****************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+
+/* Datensatz Typen, wie in lib/inc/telemetry.h */
+#define TLM_ENCODER   0x01
+#define TLM_LINE      0x02
+#define TLM_ODOMETRY  0x03
+#define TLM_BATTERY   0x04
+#define TLM_SWITCH    0x05
+#define TLM_STREAM    0x10
+
+#define MAX_FRAME     64
+
+static unsigned long frames, errors;
+static unsigned long long now;          /* fortgezaehlte Zeit in ms */
+static int have_time;
+
+/* Zustand der Delta-Streams */
+static struct
+{
+  int valid;                            /* Keyframe gesehen, Folge lueckenlos */
+  unsigned seq;                         /* erwartete Folgenummer */
+  int16_t last [8];
+  unsigned long long time;              /* Zeit vom vorherigen Rahmen */
+  int samples;                          /* Samples im vorherigen Rahmen */
+  unsigned long long span;              /* Abstand zweier Rahmen in ms ... */
+  int count;                            /* ... fuer count Samples, 0 = keiner */
+} stream [16];
+static unsigned long resync;            /* verworfene Stream Rahmen */
+
+
+
+/* Dallas/Maxim CRC-8, wie _crc_ibutton_update() aus avr-libc */
+static uint8_t crc8 (uint8_t crc, uint8_t data)
+{
+  int i;
+
+  crc ^= data;
+  for (i = 0; i < 8; i++)
+    crc = (crc & 1) ? (crc >> 1) ^ 0x8C : (crc >> 1);
+  return crc;
+}
+
+
+
+/* COBS Rahmen (ohne abschliessendes 0x00) dekodieren, -1 bei Fehler */
+static int cobs_decode (const uint8_t *in, int n, uint8_t *out)
+{
+  int i = 0, o = 0, code, k;
+
+  while (i < n)
+  {
+    code = in [i++];
+    if (code == 0 || i + code - 1 > n)
+      return -1;
+    for (k = 1; k < code; k++)
+      out [o++] = in [i++];
+    if (code < 0xFF && i < n)
+      out [o++] = 0;
+  }
+  return o;
+}
+
+
+
+static int16_t s16 (const uint8_t *p)
+{
+  return (int16_t) (p [0] | (p [1] << 8));
+}
+
+
+
+static uint16_t u16 (const uint8_t *p)
+{
+  return (uint16_t) (p [0] | (p [1] << 8));
+}
+
+
+
+/* Stream Rahmen in Samples zerlegen, -1 bei Fehler */
+static int stream_frame (unsigned type, const uint8_t *p, int len)
+{
+  int id = type - TLM_STREAM;
+  int key = p [0] >> 7;
+  int nch = ((p [0] >> 4) & 7) + 1;
+  unsigned seq = p [0] & 0x0F;
+  int i = 1, ch, shift, n = 0, k;
+  int16_t val [MAX_FRAME][8];
+  uint16_t z;
+  int16_t v;
+
+  if (!key && (!stream [id].valid || seq != stream [id].seq))
+  {
+    stream [id].valid = 0;              /* Luecke: auf Keyframe warten */
+    resync ++;
+    return 0;
+  }
+  if (stream [id].valid && seq == stream [id].seq && stream [id].samples)
+  {
+    /* lueckenlos: Abstand zum vorherigen Rahmen gibt den Sample Takt */
+    stream [id].span  = now - stream [id].time;
+    stream [id].count = stream [id].samples;
+  }
+  stream [id].valid = 1;
+  stream [id].seq = (seq + 1) & 0x0F;
+
+  while (i < len)
+  {
+    for (ch = 0; ch < nch; ch++)
+    {
+      z = 0;
+      shift = 0;
+      do
+      {
+        if (i >= len || shift > 14)
+          return -1;
+        z |= (uint16_t) (p [i] & 0x7F) << shift;
+        shift += 7;
+      } while (p [i++] & 0x80);
+      v = (int16_t) ((z >> 1) ^ -(z & 1));  /* Zig-Zag zurueck */
+      if (key && n == 0)
+        stream [id].last [ch] = v;
+      else
+        stream [id].last [ch] += v;
+      val [n][ch] = stream [id].last [ch];
+    }
+    n ++;
+  }
+  stream [id].time    = now;
+  stream [id].samples = n;
+
+  /*
+    Die Rahmenzeit gehoert zum ersten Sample. Ohne vorherigen Rahmen ist
+    der Takt noch unbekannt, dann bekommen alle Samples die Rahmenzeit.
+  */
+  for (k = 0; k < n; k++)
+  {
+    printf ("%llu,%u", stream [id].count ?
+            now + (k * stream [id].span + stream [id].count / 2) / stream [id].count :
+            now, type);
+    for (ch = 0; ch < nch; ch++)
+      printf (",%d", val [k][ch]);
+    printf ("\n");
+  }
+  return 0;
+}
+
+
+
+static void frame (const uint8_t *buf, int n)
+{
+  uint8_t raw [MAX_FRAME];
+  uint8_t crc = 0;
+  uint16_t t;
+  int len, i;
+
+  len = cobs_decode (buf, n, raw);
+  if (len < 4)
+  {
+    errors ++;
+    return;
+  }
+  for (i = 0; i < len - 1; i++)
+    crc = crc8 (crc, raw [i]);
+  if (crc != raw [len - 1])
+  {
+    errors ++;
+    return;
+  }
+  frames ++;
+  len -= 4;                             /* Typ, Zeit, CRC abziehen */
+
+  /* 16 Bit Zeitstempel fortzaehlen */
+  t = u16 (raw + 1);
+  if (!have_time)
+  {
+    now = t;
+    have_time = 1;
+  }
+  else
+    now += (uint16_t) (t - (uint16_t) now);
+
+  if (raw [0] >= TLM_STREAM && raw [0] < TLM_STREAM + 16)
+  {
+    if (len < 1 || stream_frame (raw [0], raw + 3, len) < 0)
+      errors ++;
+    return;
+  }
+
+  printf ("%llu,%u", now, raw [0]);
+  switch (raw [0])
+  {
+  case TLM_ENCODER:
+    if (len >= 4)
+      printf (",%d,%d", s16 (raw + 3), s16 (raw + 5));
+    break;
+  case TLM_LINE:
+  case TLM_ODOMETRY:
+    if (len >= 4)
+      printf (",%u,%u", u16 (raw + 3), u16 (raw + 5));
+    break;
+  case TLM_BATTERY:
+    if (len >= 2)
+      printf (",%u", u16 (raw + 3));
+    break;
+  default:                              /* TLM_SWITCH und eigene Typen */
+    for (i = 0; i < len; i++)
+      printf (",%u", raw [3 + i]);
+    break;
+  }
+  printf ("\n");
+}
+
+
+
+int main (int argc, char **argv)
+{
+  FILE *in = stdin;
+  uint8_t buf [MAX_FRAME];
+  int n = 0, c;
+
+  if (argc > 1 && (in = fopen (argv [1], "rb")) == NULL)
+  {
+    perror (argv [1]);
+    return 1;
+  }
+  while ((c = getc (in)) != EOF)
+  {
+    if (c == 0)
+    {
+      if (n > 0)
+        frame (buf, n);
+      n = 0;
+    }
+    else if (n < MAX_FRAME)
+      buf [n++] = (uint8_t) c;
+    else
+    {
+      errors ++;                        /* zu lang: bis zum naechsten 0x00 */
+      n = 0;
+      while ((c = getc (in)) != EOF && c != 0)
+        ;
+    }
+  }
+  fflush (stdout);
+  fprintf (stderr, "%lu Rahmen, %lu Fehler, %lu Stream Rahmen verworfen\n",
+           frames, errors, resync);
+  return 0;
+}